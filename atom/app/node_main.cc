@@ -78,6 +78,11 @@ int NodeMain(int argc, char *argv[]) {
       }
     } while (more == true);
 
+    // Free the task runner's handles while the loop can still run their close
+    // callbacks, the loop is not alive anymore so nothing else runs here.
+    uv_task_runner->Close();
+    uv_run(env->event_loop(), UV_RUN_NOWAIT);
+
     exit_code = node::EmitExit(env);
     node::RunAtExit(env);
 
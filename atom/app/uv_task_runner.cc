@@ -4,28 +4,76 @@
 
 #include "atom/app/uv_task_runner.h"
 
-#include "base/stl_util.h"
+#include "base/logging.h"
 
 namespace atom {
 
-UvTaskRunner::UvTaskRunner(uv_loop_t* loop) : loop_(loop) {
+UvTaskRunner::DelayedTask::DelayedTask(uint64_t deadline,
+                                       uint64_t sequence_num,
+                                       const base::Closure& task)
+    : deadline(deadline), sequence_num(sequence_num), task(task) {
+}
+
+UvTaskRunner::DelayedTask::DelayedTask(const DelayedTask& other) = default;
+
+UvTaskRunner::DelayedTask::~DelayedTask() {
+}
+
+bool UvTaskRunner::DelayedTask::operator<(const DelayedTask& other) const {
+  // std::priority_queue keeps the largest element on top, so invert the order
+  // to get the earliest deadline there.
+  if (deadline != other.deadline)
+    return deadline > other.deadline;
+  return sequence_num > other.sequence_num;
+}
+
+UvTaskRunner::UvTaskRunner(uv_loop_t* loop)
+    : loop_(loop),
+      timer_(new uv_timer_t),
+      idle_(new uv_idle_t),
+      closed_(false),
+      next_sequence_num_(0) {
+  uv_timer_init(loop_, timer_);
+  timer_->data = this;
+  uv_idle_init(loop_, idle_);
+  idle_->data = this;
 }
 
 UvTaskRunner::~UvTaskRunner() {
-  for (auto& iter : tasks_) {
-    uv_unref(reinterpret_cast<uv_handle_t*>(iter.first));
-    delete iter.first;
-  }
+  DCHECK(closed_);
+}
+
+void UvTaskRunner::Close() {
+  if (closed_)
+    return;
+
+  closed_ = true;
+  immediate_tasks_.clear();
+  delayed_tasks_ = std::priority_queue<DelayedTask>();
+  uv_close(reinterpret_cast<uv_handle_t*>(timer_), UvTaskRunner::OnClose);
+  uv_close(reinterpret_cast<uv_handle_t*>(idle_), UvTaskRunner::OnClose);
 }
 
 bool UvTaskRunner::PostDelayedTask(const tracked_objects::Location& from_here,
                                    const base::Closure& task,
                                    base::TimeDelta delay) {
-  auto* timer = new uv_timer_t;
-  timer->data = this;
-  uv_timer_init(loop_, timer);
-  uv_timer_start(timer, UvTaskRunner::OnTimeout, delay.InMilliseconds(), 0);
-  tasks_[timer] = task;
+  if (closed_)
+    return false;
+
+  int64_t delay_ms = delay.InMilliseconds();
+  if (delay_ms <= 0) {
+    if (immediate_tasks_.empty())
+      uv_idle_start(idle_, UvTaskRunner::OnIdle);
+    immediate_tasks_.push_back(task);
+    return true;
+  }
+
+  uint64_t deadline = uv_now(loop_) + delay_ms;
+  bool is_earliest = delayed_tasks_.empty() ||
+                     deadline < delayed_tasks_.top().deadline;
+  delayed_tasks_.push(DelayedTask(deadline, next_sequence_num_++, task));
+  if (is_earliest)
+    ScheduleTimer();
   return true;
 }
 
@@ -40,21 +88,56 @@ bool UvTaskRunner::PostNonNestableDelayedTask(
   return PostDelayedTask(from_here, task, delay);
 }
 
+void UvTaskRunner::ScheduleTimer() {
+  if (delayed_tasks_.empty()) {
+    uv_timer_stop(timer_);
+    return;
+  }
+
+  uint64_t now = uv_now(loop_);
+  uint64_t deadline = delayed_tasks_.top().deadline;
+  uv_timer_start(timer_, UvTaskRunner::OnTimeout,
+                 deadline > now ? deadline - now : 0, 0);
+}
+
 // static
 void UvTaskRunner::OnTimeout(uv_timer_t* timer) {
   UvTaskRunner* self = static_cast<UvTaskRunner*>(timer->data);
-  if (!ContainsKey(self->tasks_, timer))
-    return;
 
-  self->tasks_[timer].Run();
-  self->tasks_.erase(timer);
-  uv_timer_stop(timer);
-  uv_close(reinterpret_cast<uv_handle_t*>(timer), UvTaskRunner::OnClose);
+  // Tasks posted by the tasks run here are due at least one loop iteration
+  // later, so this always terminates.
+  uint64_t now = uv_now(self->loop_);
+  while (!self->delayed_tasks_.empty() &&
+         self->delayed_tasks_.top().deadline <= now) {
+    base::Closure task = self->delayed_tasks_.top().task;
+    self->delayed_tasks_.pop();
+    task.Run();
+  }
+
+  self->ScheduleTimer();
+}
+
+// static
+void UvTaskRunner::OnIdle(uv_idle_t* idle) {
+  UvTaskRunner* self = static_cast<UvTaskRunner*>(idle->data);
+
+  // Only run the tasks that are queued now, tasks they post run in the next
+  // iteration so uv events are not starved.
+  std::deque<base::Closure> tasks;
+  tasks.swap(self->immediate_tasks_);
+  for (const base::Closure& task : tasks)
+    task.Run();
+
+  if (self->immediate_tasks_.empty())
+    uv_idle_stop(idle);
 }
 
 // static
 void UvTaskRunner::OnClose(uv_handle_t* handle) {
-  delete reinterpret_cast<uv_timer_t*>(handle);
+  if (handle->type == UV_TIMER)
+    delete reinterpret_cast<uv_timer_t*>(handle);
+  else
+    delete reinterpret_cast<uv_idle_t*>(handle);
 }
 
 }  // namespace atom
@@ -5,7 +5,9 @@
 #ifndef ATOM_APP_UV_TASK_RUNNER_H_
 #define ATOM_APP_UV_TASK_RUNNER_H_
 
-#include <map>
+#include <deque>
+#include <queue>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/single_thread_task_runner.h"
@@ -14,11 +16,19 @@
 namespace atom {
 
 // TaskRunner implementation that posts tasks into libuv's default loop.
+//
+// Tasks without delay are queued and drained by one idle handle, delayed tasks
+// are kept in a min-heap of deadlines served by one timer, so posting a task
+// never allocates a libuv handle.
 class UvTaskRunner : public base::SingleThreadTaskRunner {
  public:
   explicit UvTaskRunner(uv_loop_t* loop);
   ~UvTaskRunner() override;
 
+  // Closes the handles, the loop has to run once more to free them. Tasks
+  // posted afterwards are dropped.
+  void Close();
+
   // base::SingleThreadTaskRunner:
   bool PostDelayedTask(const tracked_objects::Location& from_here,
                        const base::Closure& task,
@@ -30,12 +40,37 @@ class UvTaskRunner : public base::SingleThreadTaskRunner {
       base::TimeDelta delay) override;
 
  private:
+  struct DelayedTask {
+    DelayedTask(uint64_t deadline, uint64_t sequence_num,
+                const base::Closure& task);
+    DelayedTask(const DelayedTask& other);
+    ~DelayedTask();
+
+    // Orders the heap by deadline, and tasks with the same deadline in the
+    // order they were posted.
+    bool operator<(const DelayedTask& other) const;
+
+    uint64_t deadline;
+    uint64_t sequence_num;
+    base::Closure task;
+  };
+
+  // Arms the timer for the earliest deadline in the heap.
+  void ScheduleTimer();
+
   static void OnTimeout(uv_timer_t* timer);
+  static void OnIdle(uv_idle_t* idle);
   static void OnClose(uv_handle_t* handle);
 
   uv_loop_t* loop_;
 
-  std::map<uv_timer_t*, base::Closure> tasks_;
+  uv_timer_t* timer_;
+  uv_idle_t* idle_;
+  bool closed_;
+
+  std::deque<base::Closure> immediate_tasks_;
+  std::priority_queue<DelayedTask> delayed_tasks_;
+  uint64_t next_sequence_num_;
 
   DISALLOW_COPY_AND_ASSIGN(UvTaskRunner);
 };
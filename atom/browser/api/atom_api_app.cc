@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_app.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/login_handler.h"
+#include "atom/browser/osr/osr_frame_scheduler.h"
 #include "atom/browser/relauncher.h"
 #include "atom/common/atom_command_line.h"
 #include "atom/common/native_mate_converters/callback.h"
@@ -716,6 +718,16 @@ void App::DisableHardwareAcceleration(mate::Arguments* args) {
   content::GpuDataManager::GetInstance()->DisableHardwareAcceleration();
 }
 
+void App::SetOffscreenFrameBudget(int budget_ms) {
+  OffScreenFrameScheduler::GetInstance()->SetFrameBudget(
+      base::TimeDelta::FromMilliseconds(std::max(budget_ms, 0)));
+}
+
+int App::GetOffscreenFrameBudget() {
+  return static_cast<int>(
+      OffScreenFrameScheduler::GetInstance()->frame_budget().InMilliseconds());
+}
+
 bool App::IsAccessibilitySupportEnabled() {
   auto ax_state = content::BrowserAccessibilityState::GetInstance();
   return ax_state->IsAccessibleBrowser();
@@ -878,7 +890,9 @@ void App::BuildPrototype(
       .SetMethod("isAccessibilitySupportEnabled",
                  &App::IsAccessibilitySupportEnabled)
       .SetMethod("disableHardwareAcceleration",
-                 &App::DisableHardwareAcceleration);
+                 &App::DisableHardwareAcceleration)
+      .SetMethod("setOffscreenFrameBudget", &App::SetOffscreenFrameBudget)
+      .SetMethod("getOffscreenFrameBudget", &App::GetOffscreenFrameBudget);
 }
 
 }  // namespace api
@@ -0,0 +1,404 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atom/browser/atom_browser_context.h"
+#include "atom/browser/net/atom_network_delegate.h"
+#include "atom/browser/net/url_pattern_matcher.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "native_mate/dictionary.h"
+#include "native_mate/object_template_builder.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache.h"
+#include "net/http/http_transaction_factory.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "url/gurl.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// Receives nullptr when the session has no HTTP cache.
+using BackendCallback = base::Callback<void(disk_cache::Backend*)>;
+
+// Runs |callback| with |value| in UI thread.
+template<typename T>
+void RunWithValue(const base::Callback<void(const T&)>& callback,
+                  std::unique_ptr<T> value) {
+  callback.Run(*value);
+}
+
+template<typename T>
+void RunCallbackInUI(const base::Callback<void(const T&)>& callback,
+                     std::unique_ptr<T> value) {
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&RunWithValue<T>, callback, base::Passed(&value)));
+}
+
+void RunEvictCallbackInUI(const Cache::EvictCallback& callback, int count) {
+  if (callback.is_null())
+    return;
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                          base::Bind(callback, count));
+}
+
+// Callback of HttpCache::GetBackend.
+void OnGetBackend(disk_cache::Backend** backend_ptr,
+                  const BackendCallback& callback,
+                  int result) {
+  callback.Run(result == net::OK ? *backend_ptr : nullptr);
+}
+
+void GetBackendInIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    const BackendCallback& callback) {
+  auto request_context = getter->GetURLRequestContext();
+  auto http_cache = request_context->http_transaction_factory()->GetCache();
+  if (!http_cache) {
+    callback.Run(nullptr);
+    return;
+  }
+
+  // Call GetBackend and make the backend's ptr accessable in OnGetBackend.
+  using BackendPtr = disk_cache::Backend*;
+  auto* backend_ptr = new BackendPtr(nullptr);
+  net::CompletionCallback on_get_backend =
+      base::Bind(&OnGetBackend, base::Owned(backend_ptr), callback);
+  int rv = http_cache->GetBackend(backend_ptr, on_get_backend);
+  if (rv != net::ERR_IO_PENDING)
+    on_get_backend.Run(rv);
+}
+
+// Opens the entries of a cache backend one after another in IO thread, and
+// deletes itself after the last entry or when OnEntry asks to stop.
+class CacheWalker {
+ public:
+  explicit CacheWalker(disk_cache::Backend* backend)
+      : iterator_(backend->CreateIterator()), entry_(nullptr) {}
+  virtual ~CacheWalker() {}
+
+  void Start() {
+    OpenNextEntry();
+  }
+
+ protected:
+  // Returns false to stop the walk.
+  virtual bool OnEntry(disk_cache::Entry* entry) = 0;
+  virtual void OnDone() = 0;
+
+ private:
+  void OpenNextEntry() {
+    int rv;
+    do {
+      rv = iterator_->OpenNextEntry(
+          &entry_,
+          base::Bind(&CacheWalker::OnEntryOpened, base::Unretained(this)));
+    } while (rv != net::ERR_IO_PENDING && VisitEntry(rv));
+  }
+
+  void OnEntryOpened(int rv) {
+    if (VisitEntry(rv))
+      OpenNextEntry();
+  }
+
+  // Returns whether the walk goes on, otherwise |this| is deleted.
+  bool VisitEntry(int rv) {
+    bool more = false;
+    if (rv == net::OK) {
+      more = OnEntry(entry_);
+      entry_->Close();
+      entry_ = nullptr;
+    }
+    if (!more) {
+      OnDone();
+      delete this;
+    }
+    return more;
+  }
+
+  std::unique_ptr<disk_cache::Backend::Iterator> iterator_;
+  disk_cache::Entry* entry_;
+
+  DISALLOW_COPY_AND_ASSIGN(CacheWalker);
+};
+
+// Collects the entries whose key starts with |url_prefix|.
+class EntriesWalker : public CacheWalker {
+ public:
+  EntriesWalker(disk_cache::Backend* backend,
+                const std::string& url_prefix,
+                int limit,
+                const Cache::EntriesCallback& callback)
+      : CacheWalker(backend),
+        url_prefix_(url_prefix),
+        limit_(limit),
+        callback_(callback),
+        entries_(new base::ListValue) {}
+
+ protected:
+  bool OnEntry(disk_cache::Entry* entry) override {
+    const std::string key = entry->GetKey();
+    if (!base::StartsWith(key, url_prefix_, base::CompareCase::SENSITIVE))
+      return true;
+
+    int64_t size = 0;
+    // The headers, body and metadata of the response.
+    for (int i = 0; i < 3; ++i)
+      size += entry->GetDataSize(i);
+
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    dict->SetString("url", key);
+    dict->SetDouble("size", size);
+    dict->SetDouble("lastUsed", entry->GetLastUsed().ToDoubleT());
+    dict->SetDouble("lastModified", entry->GetLastModified().ToDoubleT());
+    entries_->Append(std::move(dict));
+    return limit_ <= 0 || static_cast<int>(entries_->GetSize()) < limit_;
+  }
+
+  void OnDone() override {
+    RunCallbackInUI(callback_, std::move(entries_));
+  }
+
+ private:
+  std::string url_prefix_;
+  int limit_;
+  Cache::EntriesCallback callback_;
+  std::unique_ptr<base::ListValue> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(EntriesWalker);
+};
+
+// Dooms the entries matching |url_patterns| that were used in
+// [begin_time, end_time).
+class EvictWalker : public CacheWalker {
+ public:
+  EvictWalker(disk_cache::Backend* backend,
+              const URLPatterns& url_patterns,
+              const base::Time& begin_time,
+              const base::Time& end_time,
+              const Cache::EvictCallback& callback)
+      : CacheWalker(backend),
+        url_patterns_(url_patterns),
+        begin_time_(begin_time),
+        end_time_(end_time),
+        callback_(callback),
+        count_(0) {}
+
+ protected:
+  bool OnEntry(disk_cache::Entry* entry) override {
+    const base::Time last_used = entry->GetLastUsed();
+    if (last_used >= begin_time_ && last_used < end_time_ &&
+        url_patterns_.MatchesURL(GURL(entry->GetKey()))) {
+      entry->Doom();
+      ++count_;
+    }
+    return true;
+  }
+
+  void OnDone() override {
+    RunEvictCallbackInUI(callback_, count_);
+  }
+
+ private:
+  URLPatternMatcher url_patterns_;
+  base::Time begin_time_;
+  base::Time end_time_;
+  Cache::EvictCallback callback_;
+  int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(EvictWalker);
+};
+
+void OnGetBackendForEntries(const std::string& url_prefix,
+                            int limit,
+                            const Cache::EntriesCallback& callback,
+                            disk_cache::Backend* backend) {
+  if (backend)
+    (new EntriesWalker(backend, url_prefix, limit, callback))->Start();
+  else
+    RunCallbackInUI(callback, base::WrapUnique(new base::ListValue));
+}
+
+void OnEntriesDoomed(disk_cache::Backend* backend,
+                     int32_t count_before,
+                     const Cache::EvictCallback& callback,
+                     int result) {
+  int count = 0;
+  if (result == net::OK)
+    count = count_before - backend->GetEntryCount();
+  RunEvictCallbackInUI(callback, count);
+}
+
+void OnGetBackendForEvict(const URLPatterns& url_patterns,
+                          const base::Time& begin_time,
+                          const base::Time& end_time,
+                          const Cache::EvictCallback& callback,
+                          disk_cache::Backend* backend) {
+  if (!backend) {
+    RunEvictCallbackInUI(callback, 0);
+  } else if (url_patterns.empty()) {
+    // The backend can doom a time range without opening the entries.
+    net::CompletionCallback on_doomed = base::Bind(
+        &OnEntriesDoomed, backend, backend->GetEntryCount(), callback);
+    int rv = backend->DoomEntriesBetween(begin_time, end_time, on_doomed);
+    if (rv != net::ERR_IO_PENDING)
+      on_doomed.Run(rv);
+  } else {
+    (new EvictWalker(backend, url_patterns, begin_time, end_time,
+                     callback))->Start();
+  }
+}
+
+void OnGetBackendForStats(AtomNetworkDelegate* network_delegate,
+                          const Cache::StatsCallback& callback,
+                          disk_cache::Backend* backend) {
+  std::unique_ptr<base::DictionaryValue> stats(new base::DictionaryValue);
+  int64_t size = 0;
+  int32_t entry_count = 0;
+  if (backend) {
+    entry_count = backend->GetEntryCount();
+    base::StringPairs backend_stats;
+    backend->GetStats(&backend_stats);
+    for (const auto& stat : backend_stats) {
+      if (stat.first == "Current size") {
+        base::StringToInt64(stat.second, &size);
+        break;
+      }
+    }
+  }
+  stats->SetInteger("entryCount", entry_count);
+  stats->SetDouble("size", size);
+
+  const auto& cache_stats = network_delegate->cache_stats();
+  stats->SetDouble("hits", cache_stats.hits);
+  stats->SetDouble("misses", cache_stats.misses);
+  stats->SetDouble("bytesFromCache", cache_stats.bytes_from_cache);
+  stats->SetDouble("bytesFromNetwork", cache_stats.bytes_from_network);
+  const int64_t total = cache_stats.hits + cache_stats.misses;
+  stats->SetDouble("hitRate",
+                   total ? static_cast<double>(cache_stats.hits) / total : 0);
+  RunCallbackInUI(callback, std::move(stats));
+}
+
+}  // namespace
+
+Cache::Cache(v8::Isolate* isolate, AtomBrowserContext* browser_context)
+    : browser_context_(browser_context) {
+  Init(isolate);
+}
+
+Cache::~Cache() {
+}
+
+void Cache::Entries(mate::Arguments* args) {
+  // entries([options, ]callback)
+  std::string url_prefix;
+  int limit = 0;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("urlPrefix", &url_prefix);
+    options.Get("limit", &limit);
+  }
+
+  EntriesCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("Must pass a callback");
+    return;
+  }
+
+  auto getter = make_scoped_refptr(browser_context_->GetRequestContext());
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&GetBackendInIO, getter,
+                 base::Bind(&OnGetBackendForEntries, url_prefix, limit,
+                            callback)));
+}
+
+void Cache::Evict(mate::Arguments* args) {
+  // evict(options[, callback])
+  mate::Dictionary options;
+  if (!args->GetNext(&options)) {
+    args->ThrowError("Must pass an options object");
+    return;
+  }
+
+  URLPatterns url_patterns;
+  std::vector<std::string> urls;
+  options.Get("urls", &urls);
+  for (const auto& url : urls) {
+    extensions::URLPattern pattern(extensions::URLPattern::SCHEME_ALL);
+    if (pattern.Parse(url) != extensions::URLPattern::PARSE_SUCCESS) {
+      args->ThrowError("Invalid URL pattern: " + url);
+      return;
+    }
+    url_patterns.insert(pattern);
+  }
+
+  base::Time begin_time, end_time = base::Time::Max();
+  double seconds;
+  if (options.Get("startTime", &seconds))
+    begin_time = base::Time::FromDoubleT(seconds);
+  if (options.Get("endTime", &seconds))
+    end_time = base::Time::FromDoubleT(seconds);
+
+  EvictCallback callback;
+  args->GetNext(&callback);
+
+  auto getter = make_scoped_refptr(browser_context_->GetRequestContext());
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&GetBackendInIO, getter,
+                 base::Bind(&OnGetBackendForEvict, url_patterns, begin_time,
+                            end_time, callback)));
+}
+
+void Cache::Stats(const StatsCallback& callback) {
+  auto getter = make_scoped_refptr(browser_context_->GetRequestContext());
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&GetBackendInIO, getter,
+                 base::Bind(&OnGetBackendForStats,
+                            base::Unretained(
+                                browser_context_->network_delegate()),
+                            callback)));
+}
+
+// static
+mate::Handle<Cache> Cache::Create(v8::Isolate* isolate,
+                                  AtomBrowserContext* browser_context) {
+  return mate::CreateHandle(isolate, new Cache(isolate, browser_context));
+}
+
+// static
+void Cache::BuildPrototype(v8::Isolate* isolate,
+                           v8::Local<v8::FunctionTemplate> prototype) {
+  prototype->SetClassName(mate::StringToV8(isolate, "Cache"));
+  mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
+      .SetMethod("entries", &Cache::Entries)
+      .SetMethod("evict", &Cache::Evict)
+      .SetMethod("stats", &Cache::Stats);
+}
+
+}  // namespace api
+
+}  // namespace atom
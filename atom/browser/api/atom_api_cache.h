@@ -0,0 +1,55 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_CACHE_H_
+#define ATOM_BROWSER_API_ATOM_API_CACHE_H_
+
+#include "atom/browser/api/trackable_object.h"
+#include "base/callback.h"
+#include "native_mate/arguments.h"
+#include "native_mate/handle.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace atom {
+
+class AtomBrowserContext;
+
+namespace api {
+
+// Inspects and evicts the entries of the HTTP cache of a session.
+class Cache : public mate::TrackableObject<Cache> {
+ public:
+  using EntriesCallback = base::Callback<void(const base::ListValue&)>;
+  using EvictCallback = base::Callback<void(int)>;
+  using StatsCallback = base::Callback<void(const base::DictionaryValue&)>;
+
+  static mate::Handle<Cache> Create(v8::Isolate* isolate,
+                                    AtomBrowserContext* browser_context);
+
+  static void BuildPrototype(v8::Isolate* isolate,
+                             v8::Local<v8::FunctionTemplate> prototype);
+
+ protected:
+  Cache(v8::Isolate* isolate, AtomBrowserContext* browser_context);
+  ~Cache() override;
+
+  void Entries(mate::Arguments* args);
+  void Evict(mate::Arguments* args);
+  void Stats(const StatsCallback& callback);
+
+ private:
+  scoped_refptr<AtomBrowserContext> browser_context_;
+
+  DISALLOW_COPY_AND_ASSIGN(Cache);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_CACHE_H_
@@ -4,10 +4,22 @@
 
 #include "atom/browser/api/atom_api_cookies.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "atom/browser/atom_browser_context.h"
+#include "atom/browser/net/cookie_index.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/base64.h"
+#include "base/files/file.h"
+#include "base/json/json_writer.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -23,6 +35,28 @@
 using atom::AtomCookieDelegate;
 using content::BrowserThread;
 
+namespace {
+
+// Converts |cookie| to the object passed to JavaScript and exported.
+std::unique_ptr<base::DictionaryValue> CookieToValue(
+    const net::CanonicalCookie& cookie) {
+  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+  dict->SetString("name", cookie.Name());
+  dict->SetString("value", cookie.Value());
+  dict->SetString("domain", cookie.Domain());
+  dict->SetBoolean("hostOnly",
+                   net::cookie_util::DomainIsHostOnly(cookie.Domain()));
+  dict->SetString("path", cookie.Path());
+  dict->SetBoolean("secure", cookie.IsSecure());
+  dict->SetBoolean("httpOnly", cookie.IsHttpOnly());
+  dict->SetBoolean("session", !cookie.IsPersistent());
+  if (cookie.IsPersistent())
+    dict->SetDouble("expirationDate", cookie.ExpiryDate().ToDoubleT());
+  return dict;
+}
+
+}  // namespace
+
 namespace mate {
 
 template<>
@@ -31,6 +65,14 @@ struct Converter<atom::api::Cookies::Error> {
                                    atom::api::Cookies::Error val) {
     if (val == atom::api::Cookies::SUCCESS)
       return v8::Null(isolate);
+    else if (val == atom::api::Cookies::INVALID_CURSOR)
+      return v8::Exception::Error(StringToV8(isolate, "Invalid cursor"));
+    else if (val == atom::api::Cookies::EXPORT_FAILED)
+      return v8::Exception::Error(StringToV8(isolate,
+                                             "Exporting cookies failed"));
+    else if (val == atom::api::Cookies::REMOVE_FAILED)
+      return v8::Exception::Error(StringToV8(isolate,
+                                             "Removing cookie failed"));
     else
       return v8::Exception::Error(StringToV8(isolate, "Setting cookie failed"));
   }
@@ -40,18 +82,7 @@ template<>
 struct Converter<net::CanonicalCookie> {
   static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
                                    const net::CanonicalCookie& val) {
-    mate::Dictionary dict(isolate, v8::Object::New(isolate));
-    dict.Set("name", val.Name());
-    dict.Set("value", val.Value());
-    dict.Set("domain", val.Domain());
-    dict.Set("hostOnly", net::cookie_util::DomainIsHostOnly(val.Domain()));
-    dict.Set("path", val.Path());
-    dict.Set("secure", val.IsSecure());
-    dict.Set("httpOnly", val.IsHttpOnly());
-    dict.Set("session", !val.IsPersistent());
-    if (val.IsPersistent())
-      dict.Set("expirationDate", val.ExpiryDate().ToDoubleT());
-    return dict.GetHandle();
+    return ConvertToV8(isolate, *CookieToValue(val));
   }
 };
 
@@ -76,6 +107,18 @@ struct Converter<AtomCookieDelegate::ChangeCause> {
   }
 };
 
+template<>
+struct Converter<AtomCookieDelegate::Change> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const AtomCookieDelegate::Change& val) {
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("cookie", val.cookie);
+    dict.Set("cause", val.cause);
+    dict.Set("removed", val.removed);
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -84,41 +127,100 @@ namespace api {
 
 namespace {
 
-// Returns whether |domain| matches |filter|.
-bool MatchesDomain(std::string filter, const std::string& domain) {
-  // Add a leading '.' character to the filter domain if it doesn't exist.
-  if (net::cookie_util::DomainIsHostOnly(filter))
-    filter.insert(0, ".");
-
-  std::string sub_domain(domain);
-  // Strip any leading '.' character from the input cookie domain.
-  if (!net::cookie_util::DomainIsHostOnly(sub_domain))
-    sub_domain = sub_domain.substr(1);
-
-  // Now check whether the domain argument is a subdomain of the filter domain.
-  for (sub_domain.insert(0, "."); sub_domain.length() >= filter.length();) {
-    if (sub_domain == filter)
-      return true;
-    const size_t next_dot = sub_domain.find('.', 1);  // Skip over leading dot.
-    sub_domain.erase(0, next_dot);
+// A filter of cookies.get, parsed once before matching the cookies.
+struct CookieFilter {
+  CookieFilter()
+      : has_name(false), has_path(false), has_domain(false),
+        has_secure(false), secure(false), has_session(false), session(false),
+        limit(0), has_cursor(false) {}
+
+  std::string url;
+  bool has_name;
+  std::string name;
+  bool has_path;
+  std::string path;
+  bool has_domain;
+  // The filter domain without a leading '.'.
+  std::string domain;
+  bool has_secure;
+  bool secure;
+  bool has_session;
+  bool session;
+  // The maximum number of cookies returned, 0 for no limit.
+  size_t limit;
+  // Only cookies after this key are returned.
+  bool has_cursor;
+  CookieIndex::Key cursor;
+};
+
+// Separates the parts of a cursor, it can not appear in cookies.
+const char kCursorSeparator = '\n';
+
+std::string EncodeCursor(const CookieIndex::Key& key) {
+  std::string cursor;
+  base::Base64Encode(key.site + kCursorSeparator + key.domain +
+                     kCursorSeparator + key.path + kCursorSeparator + key.name,
+                     &cursor);
+  return cursor;
+}
+
+bool DecodeCursor(const std::string& cursor, CookieIndex::Key* key) {
+  std::string decoded;
+  if (!base::Base64Decode(cursor, &decoded))
+    return false;
+  std::vector<std::string> parts = base::SplitString(
+      decoded, std::string(1, kCursorSeparator), base::KEEP_WHITESPACE,
+      base::SPLIT_WANT_ALL);
+  if (parts.size() != 4)
+    return false;
+  *key = { parts[0], parts[1], parts[2], parts[3] };
+  return true;
+}
+
+bool ParseCookieFilter(const base::DictionaryValue& dict, CookieFilter* out) {
+  dict.GetString("url", &out->url);
+  out->has_name = dict.GetString("name", &out->name);
+  out->has_path = dict.GetString("path", &out->path);
+  out->has_domain = dict.GetString("domain", &out->domain);
+  if (out->has_domain && !out->domain.empty() && out->domain[0] == '.')
+    out->domain.erase(0, 1);
+  out->has_secure = dict.GetBoolean("secure", &out->secure);
+  out->has_session = dict.GetBoolean("session", &out->session);
+  int limit;
+  if (dict.GetInteger("limit", &limit) && limit > 0)
+    out->limit = limit;
+  std::string cursor;
+  if (dict.GetString("cursor", &cursor) && !cursor.empty()) {
+    if (!DecodeCursor(cursor, &out->cursor))
+      return false;
+    out->has_cursor = true;
   }
-  return false;
+  return true;
+}
+
+// Returns whether |domain| is the filter domain or one of its subdomains.
+bool MatchesDomain(const CookieFilter& filter, base::StringPiece domain) {
+  if (domain.starts_with("."))
+    domain.remove_prefix(1);
+  if (domain == filter.domain)
+    return true;
+  return domain.size() > filter.domain.size() &&
+         domain.ends_with(filter.domain) &&
+         domain[domain.size() - filter.domain.size() - 1] == '.';
 }
 
 // Returns whether |cookie| matches |filter|.
-bool MatchesCookie(const base::DictionaryValue* filter,
+bool MatchesCookie(const CookieFilter& filter,
                    const net::CanonicalCookie& cookie) {
-  std::string str;
-  bool b;
-  if (filter->GetString("name", &str) && str != cookie.Name())
+  if (filter.has_name && filter.name != cookie.Name())
     return false;
-  if (filter->GetString("path", &str) && str != cookie.Path())
+  if (filter.has_path && filter.path != cookie.Path())
     return false;
-  if (filter->GetString("domain", &str) && !MatchesDomain(str, cookie.Domain()))
+  if (filter.has_domain && !MatchesDomain(filter, cookie.Domain()))
     return false;
-  if (filter->GetBoolean("secure", &b) && b != cookie.IsSecure())
+  if (filter.has_secure && filter.secure != cookie.IsSecure())
     return false;
-  if (filter->GetBoolean("session", &b) && b != !cookie.IsPersistent())
+  if (filter.has_session && filter.session != !cookie.IsPersistent())
     return false;
   return true;
 }
@@ -134,34 +236,113 @@ void RunCallbackInUI(const base::Closure& callback) {
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE, callback);
 }
 
-// Remove cookies from |list| not matching |filter|, and pass it to |callback|.
-void FilterCookies(std::unique_ptr<base::DictionaryValue> filter,
-                   const Cookies::GetCallback& callback,
-                   const net::CookieList& list) {
+// Collects the cookies in [begin, end) matching |filter| into |result|, up to
+// the filter's limit, and returns the cursor of the next page.
+template<typename Iterator>
+std::string CollectCookies(const CookieFilter& filter,
+                           Iterator begin, Iterator end,
+                           net::CookieList* result) {
+  // The index keeps expired cookies until the cookie monster garbage collects
+  // them, which it only does when it is accessed.
+  const base::Time now = base::Time::Now();
+  for (auto it = begin; it != end; ++it) {
+    const net::CanonicalCookie& cookie = it->second;
+    if (cookie.IsExpired(now) || !MatchesCookie(filter, cookie))
+      continue;
+    if (filter.limit && result->size() == filter.limit)
+      return EncodeCursor(CookieIndex::KeyFor(result->back()));
+    result->push_back(cookie);
+  }
+  return std::string();
+}
+
+// Runs the query of |filter| against the index of all cookies.
+void QueryCookieIndex(CookieIndex* index,
+                      const CookieFilter& filter,
+                      const Cookies::GetCallback& callback) {
+  using Iterator = CookieIndex::Map::const_iterator;
+  Iterator begin = index->cookies().begin();
+  Iterator end = index->cookies().end();
+  // Cookies of a domain all belong to the same site, unless the domain is
+  // a public suffix.
+  if (filter.has_domain)
+    index->GetSiteRange(filter.domain, &begin, &end);
+  if (filter.has_cursor) {
+    // Continue after the cursor, unless it is past the range.
+    Iterator after = index->cookies().upper_bound(filter.cursor);
+    if (after == index->cookies().end() ||
+        (end != index->cookies().end() && !(after->first < end->first)))
+      begin = end;
+    else if (begin != end && begin->first < after->first)
+      begin = after;
+  }
+
+  net::CookieList result;
+  std::string cursor = CollectCookies(filter, begin, end, &result);
+  RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result, cursor));
+}
+
+void OnAllCookiesLoaded(scoped_refptr<AtomCookieDelegate> cookie_delegate,
+                        const CookieFilter& filter,
+                        const Cookies::GetCallback& callback,
+                        const net::CookieList& list) {
+  CookieIndex* index = cookie_delegate->cookie_index();
+  index->Load(list);
+  QueryCookieIndex(index, filter, callback);
+}
+
+// Filters the cookies of a URL, which are few enough to be sorted each time.
+void OnURLCookiesLoaded(const CookieFilter& filter,
+                        const Cookies::GetCallback& callback,
+                        const net::CookieList& list) {
   net::CookieList result;
-  for (const auto& cookie : list) {
-    if (MatchesCookie(filter.get(), cookie))
-      result.push_back(cookie);
+  // Without paging the cookies keep the order of the store.
+  if (!filter.limit && !filter.has_cursor) {
+    for (const auto& cookie : list) {
+      if (MatchesCookie(filter, cookie))
+        result.push_back(cookie);
+    }
+    RunCallbackInUI(
+        base::Bind(callback, Cookies::SUCCESS, result, std::string()));
+    return;
   }
-  RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result));
+
+  CookieIndex::Map cookies;
+  for (const auto& cookie : list)
+    cookies.insert(std::make_pair(CookieIndex::KeyFor(cookie), cookie));
+
+  auto begin = filter.has_cursor ? cookies.upper_bound(filter.cursor)
+                                 : cookies.begin();
+  std::string cursor = CollectCookies(filter, begin, cookies.end(), &result);
+  RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result, cursor));
 }
 
 // Receives cookies matching |filter| in IO thread.
 void GetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                    std::unique_ptr<base::DictionaryValue> filter,
+                    scoped_refptr<AtomCookieDelegate> cookie_delegate,
+                    std::unique_ptr<base::DictionaryValue> dict,
                     const Cookies::GetCallback& callback) {
-  std::string url;
-  filter->GetString("url", &url);
+  CookieFilter filter;
+  if (!ParseCookieFilter(*dict, &filter)) {
+    RunCallbackInUI(base::Bind(callback, Cookies::INVALID_CURSOR,
+                               net::CookieList(), std::string()));
+    return;
+  }
 
-  auto filtered_callback =
-      base::Bind(FilterCookies, base::Passed(&filter), callback);
+  if (!filter.url.empty()) {
+    GetCookieStore(getter)->GetAllCookiesForURLAsync(
+        GURL(filter.url), base::Bind(OnURLCookiesLoaded, filter, callback));
+    return;
+  }
 
-  // Empty url will match all url cookies.
-  if (url.empty())
-    GetCookieStore(getter)->GetAllCookiesAsync(filtered_callback);
+  // Empty url will match all url cookies, which are read from the index once
+  // it has been loaded.
+  CookieIndex* index = cookie_delegate->cookie_index();
+  if (index->is_loaded())
+    QueryCookieIndex(index, filter, callback);
   else
-    GetCookieStore(getter)->GetAllCookiesForURLAsync(GURL(url),
-        filtered_callback);
+    GetCookieStore(getter)->GetAllCookiesAsync(
+        base::Bind(OnAllCookiesLoaded, cookie_delegate, filter, callback));
 }
 
 // Removes cookie with |url| and |name| in IO thread.
@@ -178,10 +359,11 @@ void OnSetCookie(const Cookies::SetCallback& callback, bool success) {
       base::Bind(callback, success ? Cookies::SUCCESS : Cookies::FAILED));
 }
 
-// Sets cookie with |details| in IO thread.
-void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                   std::unique_ptr<base::DictionaryValue> details,
-                   const Cookies::SetCallback& callback) {
+// Sets cookie with |details| in |store|.
+void SetCookieWithDetails(
+    net::CookieStore* store,
+    const base::DictionaryValue* details,
+    const net::CookieStore::SetCookiesCallback& callback) {
   std::string url, name, value, domain, path;
   bool secure = false;
   bool http_only = false;
@@ -217,11 +399,135 @@ void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
         base::Time::FromDoubleT(last_access_date);
   }
 
-  GetCookieStore(getter)->SetCookieWithDetailsAsync(
+  store->SetCookieWithDetailsAsync(
       GURL(url), name, value, domain, path, creation_time,
       expiration_time, last_access_time, secure, http_only,
       net::CookieSameSite::DEFAULT_MODE, false,
-      net::COOKIE_PRIORITY_DEFAULT, base::Bind(OnSetCookie, callback));
+      net::COOKIE_PRIORITY_DEFAULT, callback);
+}
+
+// Sets cookie with |details| in IO thread.
+void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                   std::unique_ptr<base::DictionaryValue> details,
+                   const Cookies::SetCallback& callback) {
+  SetCookieWithDetails(GetCookieStore(getter), details.get(),
+                       base::Bind(OnSetCookie, callback));
+}
+
+// Counts down the cookies of a batch operation and reports once after the
+// last one is done, whether all of them succeeded.
+class BatchResult : public base::RefCounted<BatchResult> {
+ public:
+  BatchResult(size_t count, const base::Callback<void(bool)>& callback)
+      : pending_(count), succeeded_(true), callback_(callback) {
+    if (!pending_)
+      callback_.Run(true);
+  }
+
+  void Done(bool success) {
+    DCHECK_GT(pending_, 0u);
+    succeeded_ &= success;
+    if (--pending_ == 0)
+      callback_.Run(succeeded_);
+  }
+
+ private:
+  friend class base::RefCounted<BatchResult>;
+  ~BatchResult() {}
+
+  size_t pending_;
+  bool succeeded_;
+  base::Callback<void(bool)> callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchResult);
+};
+
+// Sets all cookies of |list| in one IO thread task.
+void SetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    std::unique_ptr<base::ListValue> list,
+                    const Cookies::SetCallback& callback) {
+  net::CookieStore* store = GetCookieStore(getter);
+  scoped_refptr<BatchResult> result(
+      new BatchResult(list->GetSize(), base::Bind(OnSetCookie, callback)));
+  for (size_t i = 0; i < list->GetSize(); ++i) {
+    const base::DictionaryValue* details = nullptr;
+    if (list->GetDictionary(i, &details))
+      SetCookieWithDetails(store, details,
+                           base::Bind(&BatchResult::Done, result));
+    else
+      result->Done(false);
+  }
+}
+
+void OnCookiesRemoved(const Cookies::SetCallback& callback, bool success) {
+  RunCallbackInUI(
+      base::Bind(callback, success ? Cookies::SUCCESS : Cookies::REMOVE_FAILED));
+}
+
+// Removes the cookies of |list|, given by their url and name, in one IO thread
+// task.
+void RemoveCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       std::unique_ptr<base::ListValue> list,
+                       const Cookies::SetCallback& callback) {
+  net::CookieStore* store = GetCookieStore(getter);
+  scoped_refptr<BatchResult> result(
+      new BatchResult(list->GetSize(), base::Bind(OnCookiesRemoved, callback)));
+  for (size_t i = 0; i < list->GetSize(); ++i) {
+    const base::DictionaryValue* details = nullptr;
+    std::string url, name;
+    if (list->GetDictionary(i, &details) &&
+        details->GetString("url", &url) && details->GetString("name", &name))
+      store->DeleteCookieAsync(GURL(url), name,
+                               base::Bind(&BatchResult::Done, result, true));
+    else
+      result->Done(false);
+  }
+}
+
+// Writes |cookies| to |path| as one JSON object per line, in FILE thread.
+void WriteCookiesOnFile(const base::FilePath& path,
+                        const Cookies::ExportCallback& callback,
+                        const net::CookieList& cookies) {
+  // Lines are written in chunks of about this size.
+  const size_t kChunkSize = 64 * 1024;
+
+  base::File file(path, base::File::FLAG_CREATE_ALWAYS |
+                        base::File::FLAG_WRITE);
+  bool success = file.IsValid();
+  std::string chunk;
+  for (size_t i = 0; success && i < cookies.size(); ++i) {
+    std::string line;
+    base::JSONWriter::Write(*CookieToValue(cookies[i]), &line);
+    chunk.append(line);
+    chunk.push_back('\n');
+    if (chunk.size() >= kChunkSize || i == cookies.size() - 1) {
+      success = file.WriteAtCurrentPos(chunk.data(), chunk.size()) ==
+                static_cast<int>(chunk.size());
+      chunk.clear();
+    }
+  }
+
+  if (success)
+    RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS,
+                               static_cast<int>(cookies.size())));
+  else
+    RunCallbackInUI(base::Bind(callback, Cookies::EXPORT_FAILED, 0));
+}
+
+void OnCookiesLoadedForExport(const base::FilePath& path,
+                              const Cookies::ExportCallback& callback,
+                              const net::CookieList& cookies) {
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(WriteCookiesOnFile, path, callback, cookies));
+}
+
+// Reads all cookies in IO thread and writes them in FILE thread.
+void ExportCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       const base::FilePath& path,
+                       const Cookies::ExportCallback& callback) {
+  GetCookieStore(getter)->GetAllCookiesAsync(
+      base::Bind(OnCookiesLoadedForExport, path, callback));
 }
 
 }  // namespace
@@ -244,7 +550,8 @@ void Cookies::Get(const base::DictionaryValue& filter,
   auto getter = make_scoped_refptr(request_context_getter_);
   content::BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
-      base::Bind(GetCookiesOnIO, getter, Passed(&copied), callback));
+      base::Bind(GetCookiesOnIO, getter, cookie_delegate_, Passed(&copied),
+                 callback));
 }
 
 void Cookies::Remove(const GURL& url, const std::string& name,
@@ -264,12 +571,43 @@ void Cookies::Set(const base::DictionaryValue& details,
       base::Bind(SetCookieOnIO, getter, Passed(&copied), callback));
 }
 
+void Cookies::SetMany(const base::ListValue& list,
+                      const SetCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(list.CreateDeepCopy());
+  auto getter = make_scoped_refptr(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(SetCookiesOnIO, getter, Passed(&copied), callback));
+}
+
+void Cookies::RemoveMany(const base::ListValue& list,
+                         const SetCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(list.CreateDeepCopy());
+  auto getter = make_scoped_refptr(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(RemoveCookiesOnIO, getter, Passed(&copied), callback));
+}
+
+void Cookies::Export(const base::FilePath& path,
+                     const ExportCallback& callback) {
+  auto getter = make_scoped_refptr(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(ExportCookiesOnIO, getter, path, callback));
+}
+
 void Cookies::OnCookieChanged(const net::CanonicalCookie& cookie,
                               bool removed,
                               AtomCookieDelegate::ChangeCause cause) {
   Emit("changed", cookie, cause, removed);
 }
 
+void Cookies::OnCookiesChanged(
+    const std::vector<AtomCookieDelegate::Change>& changes) {
+  Emit("batch-changed", changes);
+}
+
 
 // static
 mate::Handle<Cookies> Cookies::Create(
@@ -285,7 +623,10 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("get", &Cookies::Get)
       .SetMethod("remove", &Cookies::Remove)
-      .SetMethod("set", &Cookies::Set);
+      .SetMethod("set", &Cookies::Set)
+      .SetMethod("setMany", &Cookies::SetMany)
+      .SetMethod("removeMany", &Cookies::RemoveMany)
+      .SetMethod("export", &Cookies::Export);
 }
 
 }  // namespace api
@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/net/atom_cookie_delegate.h"
@@ -15,6 +16,8 @@
 
 namespace base {
 class DictionaryValue;
+class FilePath;
+class ListValue;
 }
 
 namespace net {
@@ -33,10 +36,19 @@ class Cookies : public mate::TrackableObject<Cookies>,
   enum Error {
     SUCCESS,
     FAILED,
+    INVALID_CURSOR,
+    EXPORT_FAILED,
+    REMOVE_FAILED,
   };
 
-  using GetCallback = base::Callback<void(Error, const net::CookieList&)>;
+  // Receives the cookies and the cursor of the next page, which is empty when
+  // there are no more cookies.
+  using GetCallback = base::Callback<void(Error,
+                                          const net::CookieList&,
+                                          const std::string&)>;
   using SetCallback = base::Callback<void(Error)>;
+  // Receives the number of exported cookies.
+  using ExportCallback = base::Callback<void(Error, int)>;
 
   static mate::Handle<Cookies> Create(v8::Isolate* isolate,
                                       AtomBrowserContext* browser_context);
@@ -53,11 +65,16 @@ class Cookies : public mate::TrackableObject<Cookies>,
   void Remove(const GURL& url, const std::string& name,
               const base::Closure& callback);
   void Set(const base::DictionaryValue& details, const SetCallback& callback);
+  void SetMany(const base::ListValue& list, const SetCallback& callback);
+  void RemoveMany(const base::ListValue& list, const SetCallback& callback);
+  void Export(const base::FilePath& path, const ExportCallback& callback);
 
   // AtomCookieDelegate::Observer:
   void OnCookieChanged(const net::CanonicalCookie& cookie,
                        bool removed,
                        AtomCookieDelegate::ChangeCause cause) override;
+  void OnCookiesChanged(
+      const std::vector<AtomCookieDelegate::Change>& changes) override;
 
  private:
   net::URLRequestContextGetter* request_context_getter_;
@@ -38,7 +38,7 @@ namespace atom {
 
 namespace api {
 
-DesktopCapturer::DesktopCapturer(v8::Isolate* isolate) {
+DesktopCapturer::DesktopCapturer(v8::Isolate* isolate) : updating_(false) {
   Init(isolate);
 }
 
@@ -48,6 +48,32 @@ DesktopCapturer::~DesktopCapturer() {
 void DesktopCapturer::StartHandling(bool capture_window,
                                     bool capture_screen,
                                     const gfx::Size& thumbnail_size) {
+  updating_ = false;
+  CreateMediaList(capture_window, capture_screen, thumbnail_size);
+  media_list_->StartUpdating(this);
+}
+
+void DesktopCapturer::StartUpdating(bool capture_window,
+                                    bool capture_screen,
+                                    const gfx::Size& thumbnail_size,
+                                    int update_period) {
+  updating_ = true;
+  CreateMediaList(capture_window, capture_screen, thumbnail_size);
+  if (update_period > 0)
+    media_list_->SetUpdatePeriod(
+        base::TimeDelta::FromMilliseconds(update_period));
+  media_list_->StartUpdating(this);
+}
+
+void DesktopCapturer::StopUpdating() {
+  // The media list stops refreshing when OnRefreshFinished returns false, it
+  // can not be destroyed here since this may be called from its callbacks.
+  updating_ = false;
+}
+
+void DesktopCapturer::CreateMediaList(bool capture_window,
+                                      bool capture_screen,
+                                      const gfx::Size& thumbnail_size) {
   webrtc::DesktopCaptureOptions options =
       webrtc::DesktopCaptureOptions::CreateDefault();
 
@@ -69,25 +95,53 @@ void DesktopCapturer::StartHandling(bool capture_window,
       std::move(screen_capturer), std::move(window_capturer)));
 
   media_list_->SetThumbnailSize(thumbnail_size);
-  media_list_->StartUpdating(this);
 }
 
 void DesktopCapturer::OnSourceAdded(int index) {
+  if (!updating_)
+    return;
+  // The thumbnail of a new source comes later with a thumbnail change.
+  const DesktopMediaList::Source& source = media_list_->GetSource(index);
+  Emit("source-added", index, source.id.ToString(),
+       base::UTF16ToUTF8(source.name));
 }
 
 void DesktopCapturer::OnSourceRemoved(int index) {
+  if (!updating_)
+    return;
+  Emit("source-removed", index, media_list_->GetSource(index).id.ToString());
 }
 
 void DesktopCapturer::OnSourceMoved(int old_index, int new_index) {
+  if (!updating_)
+    return;
+  Emit("source-moved", old_index, new_index,
+       media_list_->GetSource(new_index).id.ToString());
 }
 
 void DesktopCapturer::OnSourceNameChanged(int index) {
+  if (!updating_)
+    return;
+  const DesktopMediaList::Source& source = media_list_->GetSource(index);
+  Emit("source-name-changed", index, source.id.ToString(),
+       base::UTF16ToUTF8(source.name));
 }
 
 void DesktopCapturer::OnSourceThumbnailChanged(int index) {
+  if (!updating_)
+    return;
+  // The media list only scales the frames whose hash has changed, so only
+  // those are converted here.
+  const DesktopMediaList::Source& source = media_list_->GetSource(index);
+  Emit("source-thumbnail-changed", index, source.id.ToString(),
+       NativeImage::Create(isolate(), gfx::Image(source.thumbnail)));
 }
 
 bool DesktopCapturer::OnRefreshFinished() {
+  if (updating_) {
+    Emit("refresh-finished");
+    return updating_;
+  }
   Emit("finished", media_list_->GetSources());
   return false;
 }
@@ -102,7 +156,9 @@ void DesktopCapturer::BuildPrototype(
     v8::Isolate* isolate, v8::Local<v8::FunctionTemplate> prototype) {
   prototype->SetClassName(mate::StringToV8(isolate, "DesktopCapturer"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
-      .SetMethod("startHandling", &DesktopCapturer::StartHandling);
+      .SetMethod("startHandling", &DesktopCapturer::StartHandling)
+      .SetMethod("startUpdating", &DesktopCapturer::StartUpdating)
+      .SetMethod("stopUpdating", &DesktopCapturer::StopUpdating);
 }
 
 }  // namespace api
@@ -116,6 +172,7 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   v8::Isolate* isolate = context->GetIsolate();
   mate::Dictionary dict(isolate, exports);
   dict.Set("desktopCapturer", atom::api::DesktopCapturer::Create(isolate));
+  dict.SetMethod("createDesktopCapturer", &atom::api::DesktopCapturer::Create);
 }
 
 }  // namespace
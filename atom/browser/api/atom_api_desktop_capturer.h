@@ -22,10 +22,19 @@ class DesktopCapturer: public mate::EventEmitter<DesktopCapturer>,
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
+  // Gathers the sources once and emits "finished" with all of them.
   void StartHandling(bool capture_window,
                      bool capture_screen,
                      const gfx::Size& thumbnail_size);
 
+  // Keeps refreshing the sources every |update_period| milliseconds and emits
+  // an event for each change, until StopUpdating() is called.
+  void StartUpdating(bool capture_window,
+                     bool capture_screen,
+                     const gfx::Size& thumbnail_size,
+                     int update_period);
+  void StopUpdating();
+
  protected:
   explicit DesktopCapturer(v8::Isolate* isolate);
   ~DesktopCapturer() override;
@@ -39,8 +48,15 @@ class DesktopCapturer: public mate::EventEmitter<DesktopCapturer>,
   bool OnRefreshFinished() override;
 
  private:
+  void CreateMediaList(bool capture_window,
+                       bool capture_screen,
+                       const gfx::Size& thumbnail_size);
+
   std::unique_ptr<DesktopMediaList> media_list_;
 
+  // Whether the changes of sources are emitted as they happen.
+  bool updating_;
+
   DISALLOW_COPY_AND_ASSIGN(DesktopCapturer);
 };
 
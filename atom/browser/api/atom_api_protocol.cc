@@ -10,8 +10,11 @@
 #include "atom/browser/net/url_request_async_asar_job.h"
 #include "atom/browser/net/url_request_buffer_job.h"
 #include "atom/browser/net/url_request_fetch_job.h"
+#include "atom/browser/net/url_request_stream_job.h"
+#include "atom/browser/net/worker_protocol_handler.h"
 #include "atom/browser/net/url_request_string_job.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
@@ -76,6 +79,49 @@ void Protocol::RegisterServiceWorkerSchemes(
   atom::AtomBrowserClient::SetCustomServiceWorkerSchemes(schemes);
 }
 
+void Protocol::RegisterWorkerProtocol(const std::string& scheme,
+                                      const mate::Dictionary& options,
+                                      mate::Arguments* args) {
+  base::FilePath script;
+  if (!options.Get("script", &script) || !script.IsAbsolute()) {
+    args->ThrowError("script must be an absolute path");
+    return;
+  }
+
+  int workers = ProtocolWorkerPool::GetDefaultWorkerCount();
+  if (options.Get("workers", &workers) && workers < 1) {
+    args->ThrowError("workers must be a positive number");
+    return;
+  }
+
+  CompletionCallback callback;
+  args->GetNext(&callback);
+  content::BrowserThread::PostTaskAndReplyWithResult(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&Protocol::RegisterWorkerProtocolInIO,
+                 request_context_getter_, scheme,
+                 make_scoped_refptr(new ProtocolWorkerPool(script, workers))),
+      base::Bind(&Protocol::OnIOCompleted,
+                 GetWeakPtr(), callback));
+}
+
+// static
+Protocol::ProtocolError Protocol::RegisterWorkerProtocolInIO(
+    scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+    const std::string& scheme,
+    scoped_refptr<ProtocolWorkerPool> worker_pool) {
+  auto job_factory = static_cast<AtomURLRequestJobFactory*>(
+      request_context_getter->job_factory());
+  if (job_factory->IsHandledProtocol(scheme))
+    return PROTOCOL_REGISTERED;
+  std::unique_ptr<WorkerProtocolHandler> protocol_handler(
+      new WorkerProtocolHandler(worker_pool));
+  if (job_factory->SetProtocolHandler(scheme, std::move(protocol_handler)))
+    return PROTOCOL_OK;
+  else
+    return PROTOCOL_FAIL;
+}
+
 void Protocol::UnregisterProtocol(
     const std::string& scheme, mate::Arguments* args) {
   CompletionCallback callback;
@@ -193,6 +239,9 @@ void Protocol::BuildPrototype(
                  &Protocol::RegisterProtocol<URLRequestAsyncAsarJob>)
       .SetMethod("registerHttpProtocol",
                  &Protocol::RegisterProtocol<URLRequestFetchJob>)
+      .SetMethod("registerStreamProtocol",
+                 &Protocol::RegisterProtocol<URLRequestStreamJob>)
+      .SetMethod("registerWorkerProtocol", &Protocol::RegisterWorkerProtocol)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
       .SetMethod("interceptStringProtocol",
@@ -203,6 +252,8 @@ void Protocol::BuildPrototype(
                  &Protocol::InterceptProtocol<URLRequestAsyncAsarJob>)
       .SetMethod("interceptHttpProtocol",
                  &Protocol::InterceptProtocol<URLRequestFetchJob>)
+      .SetMethod("interceptStreamProtocol",
+                 &Protocol::InterceptProtocol<URLRequestStreamJob>)
       .SetMethod("uninterceptProtocol", &Protocol::UninterceptProtocol);
 }
 
@@ -12,6 +12,9 @@
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/net/atom_url_request_job_factory.h"
+#include "atom/browser/net/protocol_response_cache.h"
+#include "atom/browser/net/protocol_worker_pool.h"
+#include "atom/browser/net/url_request_cached_job.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "content/public/browser/browser_thread.h"
@@ -71,14 +74,24 @@ class Protocol : public mate::TrackableObject<Protocol> {
         const Handler& handler)
         : isolate_(isolate),
           request_context_(request_context),
-          handler_(handler) {}
+          handler_(handler),
+          response_cache_(new ProtocolResponseCache) {}
     ~CustomProtocolHandler() override {}
 
     net::URLRequestJob* MaybeCreateJob(
         net::URLRequest* request,
         net::NetworkDelegate* network_delegate) const override {
+      // Responses the handler allowed to cache are served without asking it.
+      if (request->method() == "GET") {
+        const ProtocolResponseCache::Entry* entry =
+            response_cache_->Get(request->url());
+        if (entry)
+          return new URLRequestCachedJob(request, network_delegate, *entry);
+      }
+
       RequestJob* request_job = new RequestJob(request, network_delegate);
-      request_job->SetHandlerInfo(isolate_, request_context_.get(), handler_);
+      request_job->SetHandlerInfo(isolate_, request_context_.get(), handler_,
+                                  response_cache_.get());
       return request_job;
     }
 
@@ -86,6 +99,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
     v8::Isolate* isolate_;
     scoped_refptr<net::URLRequestContextGetter> request_context_;
     Protocol::Handler handler_;
+    scoped_refptr<ProtocolResponseCache> response_cache_;
 
     DISALLOW_COPY_AND_ASSIGN(CustomProtocolHandler);
   };
@@ -126,6 +140,15 @@ class Protocol : public mate::TrackableObject<Protocol> {
       return PROTOCOL_FAIL;
   }
 
+  // Register the protocol with handlers running in worker threads.
+  void RegisterWorkerProtocol(const std::string& scheme,
+                              const mate::Dictionary& options,
+                              mate::Arguments* args);
+  static ProtocolError RegisterWorkerProtocolInIO(
+      scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+      const std::string& scheme,
+      scoped_refptr<ProtocolWorkerPool> worker_pool);
+
   // Unregister the protocol handler that handles |scheme|.
   void UnregisterProtocol(const std::string& scheme, mate::Arguments* args);
   static ProtocolError UnregisterProtocolInIO(
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "atom/browser/api/atom_api_cache.h"
 #include "atom/browser/api/atom_api_cookies.h"
 #include "atom/browser/api/atom_api_download_item.h"
 #include "atom/browser/api/atom_api_protocol.h"
@@ -17,6 +18,7 @@
 #include "atom/browser/atom_permission_manager.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/net/atom_cert_verifier.h"
+#include "atom/common/api/object_life_monitor.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
@@ -331,10 +333,46 @@ void OnClearStorageDataDone(const base::Closure& callback) {
     callback.Run();
 }
 
+// Closes a blob stream when the JavaScript stream reading it is garbage
+// collected without having been read to its end or destroyed.
+class BlobStreamCloser : public ObjectLifeMonitor {
+ public:
+  static void BindTo(v8::Isolate* isolate,
+                     v8::Local<v8::Object> target,
+                     AtomBrowserContext* browser_context,
+                     int id) {
+    new BlobStreamCloser(isolate, target, browser_context, id);
+  }
+
+ protected:
+  BlobStreamCloser(v8::Isolate* isolate,
+                   v8::Local<v8::Object> target,
+                   AtomBrowserContext* browser_context,
+                   int id)
+      : ObjectLifeMonitor(isolate, target),
+        browser_context_(browser_context),
+        id_(id) {}
+
+  void RunDestructor() override {
+    // Closing a stream that has already been closed does nothing.
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&AtomBlobReader::CloseStream,
+                   base::Unretained(browser_context_->GetBlobReader()),
+                   id_));
+  }
+
+ private:
+  scoped_refptr<AtomBrowserContext> browser_context_;
+  int id_;
+
+  DISALLOW_COPY_AND_ASSIGN(BlobStreamCloser);
+};
+
 }  // namespace
 
 Session::Session(v8::Isolate* isolate, AtomBrowserContext* browser_context)
     : devtools_network_emulation_client_id_(base::GenerateGUID()),
+      next_blob_stream_id_(0),
       browser_context_(browser_context) {
   // Observe DownloadManager to get download notifications.
   content::BrowserContext::GetDownloadManager(browser_context)->
@@ -520,6 +558,53 @@ void Session::GetBlobData(
                  callback));
 }
 
+int Session::OpenBlobStream(const std::string& uuid,
+                            int64_t offset,
+                            int64_t length,
+                            v8::Local<v8::Object> stream) {
+  int id = ++next_blob_stream_id_;
+  BlobStreamCloser::BindTo(isolate(), stream, browser_context(), id);
+  AtomBlobReader* blob_reader =
+      browser_context()->GetBlobReader();
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&AtomBlobReader::OpenStream,
+                 base::Unretained(blob_reader),
+                 id, uuid, offset, length));
+  return id;
+}
+
+void Session::ReadBlobStream(
+    int id,
+    int max_bytes,
+    const AtomBlobReader::CompletionCallback& callback) {
+  if (callback.is_null())
+    return;
+
+  AtomBlobReader* blob_reader =
+      browser_context()->GetBlobReader();
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&AtomBlobReader::ReadStream,
+                 base::Unretained(blob_reader),
+                 id, max_bytes, callback));
+}
+
+void Session::CloseBlobStream(int id) {
+  AtomBlobReader* blob_reader =
+      browser_context()->GetBlobReader();
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&AtomBlobReader::CloseStream,
+                 base::Unretained(blob_reader),
+                 id));
+}
+
+v8::Local<v8::Value> Session::Cache(v8::Isolate* isolate) {
+  if (cache_.IsEmpty()) {
+    auto handle = atom::api::Cache::Create(isolate, browser_context());
+    cache_.Reset(isolate, handle.ToV8());
+  }
+  return v8::Local<v8::Value>::New(isolate, cache_);
+}
+
 v8::Local<v8::Value> Session::Cookies(v8::Isolate* isolate) {
   if (cookies_.IsEmpty()) {
     auto handle = Cookies::Create(isolate, browser_context());
@@ -603,6 +688,10 @@ void Session::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setUserAgent", &Session::SetUserAgent)
       .SetMethod("getUserAgent", &Session::GetUserAgent)
       .SetMethod("getBlobData", &Session::GetBlobData)
+      .SetMethod("_openBlobStream", &Session::OpenBlobStream)
+      .SetMethod("_readBlobStream", &Session::ReadBlobStream)
+      .SetMethod("_closeBlobStream", &Session::CloseBlobStream)
+      .SetProperty("cache", &Session::Cache)
       .SetProperty("cookies", &Session::Cookies)
       .SetProperty("protocol", &Session::Protocol)
       .SetProperty("webRequest", &Session::WebRequest);
@@ -624,6 +713,12 @@ v8::Local<v8::Value> FromPartition(
   }
   base::DictionaryValue options;
   args->GetNext(&options);
+  std::string cache_type;
+  if (options.GetString("cache", &cache_type) &&
+      cache_type != "memory" && cache_type != "disk") {
+    args->ThrowError("Invalid cache option: " + cache_type);
+    return v8::Null(args->isolate());
+  }
   return Session::FromPartition(args->isolate(), partition, options).ToV8();
 }
 
@@ -79,6 +79,16 @@ class Session: public mate::TrackableObject<Session>,
   std::string GetUserAgent();
   void GetBlobData(const std::string& uuid,
                    const AtomBlobReader::CompletionCallback& callback);
+  // The stream is closed when |stream| is garbage collected.
+  int OpenBlobStream(const std::string& uuid,
+                     int64_t offset,
+                     int64_t length,
+                     v8::Local<v8::Object> stream);
+  void ReadBlobStream(int id,
+                      int max_bytes,
+                      const AtomBlobReader::CompletionCallback& callback);
+  void CloseBlobStream(int id);
+  v8::Local<v8::Value> Cache(v8::Isolate* isolate);
   v8::Local<v8::Value> Cookies(v8::Isolate* isolate);
   v8::Local<v8::Value> Protocol(v8::Isolate* isolate);
   v8::Local<v8::Value> WebRequest(v8::Isolate* isolate);
@@ -93,6 +103,7 @@ class Session: public mate::TrackableObject<Session>,
 
  private:
   // Cached object.
+  v8::Global<v8::Value> cache_;
   v8::Global<v8::Value> cookies_;
   v8::Global<v8::Value> protocol_;
   v8::Global<v8::Value> web_request_;
@@ -100,6 +111,9 @@ class Session: public mate::TrackableObject<Session>,
   // The X-DevTools-Emulate-Network-Conditions-Client-Id.
   std::string devtools_network_emulation_client_id_;
 
+  // The id of the last stream of createBlobReadStream.
+  int next_blob_stream_id_;
+
   scoped_refptr<AtomBrowserContext> browser_context_;
 
   DISALLOW_COPY_AND_ASSIGN(Session);
@@ -13,6 +13,19 @@
 #include "atom/common/node_includes.h"
 #include "native_mate/dictionary.h"
 
+namespace {
+
+// Chunked uploads stop accepting writes when more than this many bytes are
+// waiting to be sent, until "drain" is emitted.
+const int64_t kUploadHighWaterMark = 1024 * 1024;
+
+// Releases the IOBuffer owning the memory of a garbage collected Buffer.
+void ReleaseIOBuffer(char* data, void* hint) {
+  static_cast<const net::IOBufferWithSize*>(hint)->Release();
+}
+
+}  // namespace
+
 namespace mate {
 
 template <>
@@ -20,7 +33,12 @@ struct Converter<scoped_refptr<const net::IOBufferWithSize>> {
   static v8::Local<v8::Value> ToV8(
       v8::Isolate* isolate,
       scoped_refptr<const net::IOBufferWithSize> buffer) {
-    return node::Buffer::Copy(isolate, buffer->data(), buffer->size())
+    // The Buffer uses the memory of the IOBuffer, which is kept alive until
+    // the Buffer is garbage collected.
+    buffer->AddRef();
+    return node::Buffer::New(isolate, buffer->data(), buffer->size(),
+                             ReleaseIOBuffer,
+                             const_cast<net::IOBufferWithSize*>(buffer.get()))
         .ToLocalChecked();
   }
 
@@ -44,8 +62,8 @@ struct Converter<scoped_refptr<const net::IOBufferWithSize>> {
     }
 
     *out = new net::IOBufferWithSize(size);
-    // We do a deep copy. We could have used Buffer's internal memory
-    // but that is much more complicated to be properly handled.
+    // We do a deep copy, so the Buffer can be reused as soon as write()
+    // returns, while sent chunks may still be kept to rewind the upload.
     memcpy((*out)->data(), data, size);
     return true;
   }
@@ -122,7 +140,10 @@ bool URLRequest::ResponseState::Failed() const {
   return IsFlagSet(ResponseStateFlags::kFailed);
 }
 
-URLRequest::URLRequest(v8::Isolate* isolate, v8::Local<v8::Object> wrapper) {
+URLRequest::URLRequest(v8::Isolate* isolate, v8::Local<v8::Object> wrapper)
+    : is_chunked_upload_(false),
+      pending_upload_bytes_(0),
+      upload_needs_drain_(false) {
   InitWith(isolate, wrapper);
 }
 
@@ -176,6 +197,8 @@ void URLRequest::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setExtraHeader", &URLRequest::SetExtraHeader)
       .SetMethod("removeExtraHeader", &URLRequest::RemoveExtraHeader)
       .SetMethod("setChunkedUpload", &URLRequest::SetChunkedUpload)
+      .SetMethod("pauseResponse", &URLRequest::PauseResponse)
+      .SetMethod("resumeResponse", &URLRequest::ResumeResponse)
       .SetProperty("notStarted", &URLRequest::NotStarted)
       .SetProperty("finished", &URLRequest::Finished)
       // Response APi
@@ -217,10 +240,17 @@ bool URLRequest::Write(scoped_refptr<const net::IOBufferWithSize> buffer,
   }
 
   DCHECK(atom_request_);
-  if (atom_request_) {
-    return atom_request_->Write(buffer, is_last);
+  if (!atom_request_ || !atom_request_->Write(buffer, is_last))
+    return false;
+
+  // Only chunked uploads are sent while writing, other uploads are kept in
+  // memory until the request ends anyway.
+  if (is_chunked_upload_ && buffer) {
+    pending_upload_bytes_ += buffer->size();
+    if (pending_upload_bytes_ > kUploadHighWaterMark)
+      upload_needs_drain_ = true;
   }
-  return false;
+  return !upload_needs_drain_;
 }
 
 void URLRequest::Cancel() {
@@ -290,6 +320,17 @@ void URLRequest::SetChunkedUpload(bool is_chunked_upload) {
   if (atom_request_) {
     atom_request_->SetChunkedUpload(is_chunked_upload);
   }
+  is_chunked_upload_ = is_chunked_upload;
+}
+
+void URLRequest::PauseResponse() {
+  if (atom_request_)
+    atom_request_->PauseReading();
+}
+
+void URLRequest::ResumeResponse() {
+  if (atom_request_)
+    atom_request_->ResumeReading();
 }
 
 void URLRequest::OnAuthenticationRequired(
@@ -319,6 +360,18 @@ void URLRequest::OnResponseStarted(
   Emit("response");
 }
 
+void URLRequest::OnUploadDataConsumed(int num_bytes) {
+  pending_upload_bytes_ -= num_bytes;
+  if (request_state_.Canceled() || request_state_.Closed() ||
+      request_state_.Failed()) {
+    return;
+  }
+  if (upload_needs_drain_ && pending_upload_bytes_ <= kUploadHighWaterMark) {
+    upload_needs_drain_ = false;
+    EmitRequestEvent(false, "drain");
+  }
+}
+
 void URLRequest::OnResponseData(
     scoped_refptr<const net::IOBufferWithSize> buffer) {
   if (request_state_.Canceled() || request_state_.Closed() ||
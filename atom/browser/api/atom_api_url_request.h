@@ -103,6 +103,7 @@ class URLRequest : public mate::EventEmitter<URLRequest> {
       scoped_refptr<const net::AuthChallengeInfo> auth_info);
   void OnResponseStarted(
       scoped_refptr<net::HttpResponseHeaders> response_headers);
+  void OnUploadDataConsumed(int num_bytes);
   void OnResponseData(scoped_refptr<const net::IOBufferWithSize> data);
   void OnResponseCompleted();
   void OnError(const std::string& error, bool isRequestError);
@@ -173,6 +174,8 @@ class URLRequest : public mate::EventEmitter<URLRequest> {
   bool SetExtraHeader(const std::string& name, const std::string& value);
   void RemoveExtraHeader(const std::string& name);
   void SetChunkedUpload(bool is_chunked_upload);
+  void PauseResponse();
+  void ResumeResponse();
 
   int StatusCode() const;
   std::string StatusMessage() const;
@@ -192,6 +195,11 @@ class URLRequest : public mate::EventEmitter<URLRequest> {
   RequestState request_state_;
   ResponseState response_state_;
 
+  bool is_chunked_upload_;
+  // Bytes of a chunked upload that have been written but not sent yet.
+  int64_t pending_upload_bytes_;
+  bool upload_needs_drain_;
+
   // Used to implement pin/unpin.
   v8::Global<v8::Object> wrapper_;
   scoped_refptr<net::HttpResponseHeaders> response_headers_;
@@ -4,8 +4,11 @@
 
 #include "atom/browser/api/atom_api_web_contents.h"
 
+#include <algorithm>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/atom_api_debugger.h"
 #include "atom/browser/api/atom_api_session.h"
@@ -27,6 +30,7 @@
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
 #include "atom/common/color_util.h"
+#include "atom/common/event_loop_stats.h"
 #include "atom/common/mouse_util.h"
 #include "atom/common/native_mate_converters/blink_converter.h"
 #include "atom/common/native_mate_converters/callback.h"
@@ -40,6 +44,7 @@
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/worker_pool.h"
 #include "brightray/browser/inspectable_web_contents.h"
 #include "brightray/browser/inspectable_web_contents_view.h"
 #include "chrome/browser/printing/print_preview_message_handler.h"
@@ -70,6 +75,8 @@
 #include "third_party/WebKit/public/web/WebFindOptions.h"
 #include "third_party/WebKit/public/web/WebInputEvent.h"
 #include "ui/display/screen.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
 
 #if !defined(OS_MACOSX)
 #include "ui/aura/window.h"
@@ -228,6 +235,74 @@ void OnCapturePageDone(base::Callback<void(const gfx::Image&)> callback,
   callback.Run(gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
+void FreeEncodedPage(char*, void* hint) {
+  delete static_cast<std::vector<unsigned char>*>(hint);
+}
+
+// Runs in the worker pool.
+void EncodeCapturedPage(const SkBitmap& bitmap,
+                        bool jpeg,
+                        int quality,
+                        std::vector<unsigned char>* output) {
+  if (bitmap.empty())
+    return;
+  if (!jpeg) {
+    gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, output);
+    return;
+  }
+  SkAutoLockPixels lock(bitmap);
+  gfx::JPEGCodec::Encode(
+      reinterpret_cast<const unsigned char*>(bitmap.getAddr32(0, 0)),
+      gfx::JPEGCodec::FORMAT_SkBitmap, bitmap.width(), bitmap.height(),
+      static_cast<int>(bitmap.rowBytes()), quality, output);
+}
+
+void OnCapturedPageEncoded(
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    std::unique_ptr<std::vector<unsigned char>> data) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> buffer;
+  if (data->empty()) {
+    buffer = node::Buffer::New(isolate, 0).ToLocalChecked();
+  } else {
+    // The Buffer takes over the encoded data.
+    char* bytes = reinterpret_cast<char*>(data->data());
+    size_t size = data->size();
+    buffer = node::Buffer::New(isolate, bytes, size, &FreeEncodedPage,
+                               data.release()).ToLocalChecked();
+  }
+  callback.Run(buffer);
+}
+
+// Called when CapturePage with a format is done, the bitmap is encoded in the
+// worker pool instead of the UI thread.
+void OnCapturePageDoneWithFormat(
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    bool jpeg,
+    int quality,
+    const SkBitmap& bitmap,
+    content::ReadbackResponse response) {
+  std::unique_ptr<std::vector<unsigned char>> data(
+      new std::vector<unsigned char>);
+  std::vector<unsigned char>* output = data.get();
+  base::WorkerPool::PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&EncodeCapturedPage, bitmap, jpeg, quality,
+                 base::Unretained(output)),
+      base::Bind(&OnCapturedPageEncoded, callback, base::Passed(&data)),
+      true);
+}
+
+// The IPC channel chosen by the app is the first argument of the internal
+// "ipc-message" events, account their handlers to it.
+std::string GetIPCHandlerName(const base::ListValue& args) {
+  std::string channel;
+  args.GetString(0, &channel);
+  return "ipc:" + channel;
+}
+
 }  // namespace
 
 WebContents::WebContents(v8::Isolate* isolate,
@@ -303,10 +378,13 @@ WebContents::WebContents(v8::Isolate* isolate,
   } else if (IsOffScreen()) {
     bool transparent = false;
     options.Get("transparent", &transparent);
+    bool tiled = false;
+    options.Get("offscreenTiledRendering", &tiled);
 
     content::WebContents::CreateParams params(session->browser_context());
     auto* view = new OffScreenWebContentsView(
-        transparent, base::Bind(&WebContents::OnPaint, base::Unretained(this)));
+        transparent, tiled,
+        base::Bind(&WebContents::OnPaint, base::Unretained(this)));
     params.view = view;
     params.delegate_view = view;
 
@@ -1323,12 +1401,46 @@ void WebContents::StartDrag(const mate::Dictionary& item,
 }
 
 void WebContents::CapturePage(mate::Arguments* args) {
+  // capturePage([rect | options, ]callback)
   gfx::Rect rect;
-  base::Callback<void(const gfx::Image&)> callback;
+  gfx::Size scale_to;
+  std::string format;
+  int quality = 90;
+  v8::Local<v8::Value> first;
+  if (args->Length() == 2 && args->GetNext(&first)) {
+    mate::Dictionary options;
+    if (ConvertFromV8(isolate(), first, &options) &&
+        (options.Has("rect") || options.Has("scaleTo") ||
+         options.Has("format"))) {
+      options.Get("rect", &rect);
+      // Either side of |scaleTo| can be omitted.
+      mate::Dictionary scale_to_dict;
+      if (options.Get("scaleTo", &scale_to_dict)) {
+        int width = 0, height = 0;
+        scale_to_dict.Get("width", &width);
+        scale_to_dict.Get("height", &height);
+        scale_to = gfx::Size(width, height);
+      }
+      options.Get("format", &format);
+      options.Get("quality", &quality);
+      if (!format.empty() && format != "png" && format != "jpeg") {
+        args->ThrowError("Invalid format");
+        return;
+      }
+    } else if (!ConvertFromV8(isolate(), first, &rect)) {
+      args->ThrowError();
+      return;
+    }
+  } else if (args->Length() != 1) {
+    args->ThrowError();
+    return;
+  }
 
-  if (!(args->Length() == 1 && args->GetNext(&callback)) &&
-      !(args->Length() == 2 && args->GetNext(&rect)
-                            && args->GetNext(&callback))) {
+  // The callback receives the encoded data when a |format| is given.
+  base::Callback<void(const gfx::Image&)> callback;
+  base::Callback<void(v8::Local<v8::Value>)> encoded_callback;
+  if (format.empty() ? !args->GetNext(&callback) :
+                       !args->GetNext(&encoded_callback)) {
     args->ThrowError();
     return;
   }
@@ -1336,7 +1448,10 @@ void WebContents::CapturePage(mate::Arguments* args) {
   const auto view = web_contents()->GetRenderWidgetHostView();
   const auto host = view ? view->GetRenderWidgetHost() : nullptr;
   if (!view || !host) {
-    callback.Run(gfx::Image());
+    if (format.empty())
+      callback.Run(gfx::Image());
+    else
+      encoded_callback.Run(node::Buffer::New(isolate(), 0).ToLocalChecked());
     return;
   }
 
@@ -1344,6 +1459,29 @@ void WebContents::CapturePage(mate::Arguments* args) {
   const gfx::Size view_size = rect.IsEmpty() ? view->GetViewBounds().size() :
                                                rect.size();
 
+  content::ReadbackRequestCallback done;
+  if (format.empty())
+    done = base::Bind(&OnCapturePageDone, callback);
+  else
+    done = base::Bind(&OnCapturePageDoneWithFormat, encoded_callback,
+                      format == "jpeg", quality);
+
+  // Let the compositor scale the page while copying it, so the full size
+  // bitmap is never read back.
+  if (scale_to.width() > 0 || scale_to.height() > 0) {
+    if (view_size.IsEmpty())
+      scale_to = gfx::Size();
+    else if (scale_to.width() <= 0)
+      scale_to.set_width(std::max(
+          1, scale_to.height() * view_size.width() / view_size.height()));
+    else if (scale_to.height() <= 0)
+      scale_to.set_height(std::max(
+          1, scale_to.width() * view_size.height() / view_size.width()));
+    host->CopyFromBackingStore(gfx::Rect(rect.origin(), view_size),
+                               scale_to, done, kBGRA_8888_SkColorType);
+    return;
+  }
+
   // By default, the requested bitmap size is the view size in screen
   // coordinates.  However, if there's more pixel detail available on the
   // current system, increase the requested bitmap size to capture it all.
@@ -1357,7 +1495,7 @@ void WebContents::CapturePage(mate::Arguments* args) {
 
   host->CopyFromBackingStore(gfx::Rect(rect.origin(), view_size),
                              bitmap_size,
-                             base::Bind(&OnCapturePageDone, callback),
+                             done,
                              kBGRA_8888_SkColorType);
 }
 
@@ -1443,6 +1581,35 @@ int WebContents::GetFrameRate() const {
   return osr_rwhv ? osr_rwhv->GetFrameRate() : 0;
 }
 
+void WebContents::SetFramePriority(int priority) {
+  if (!IsOffScreen())
+    return;
+
+  auto* osr_rwhv = static_cast<OffScreenRenderWidgetHostView*>(
+      web_contents()->GetRenderWidgetHostView());
+  if (osr_rwhv)
+    osr_rwhv->SetFramePriority(priority);
+}
+
+int WebContents::GetFramePriority() const {
+  if (!IsOffScreen())
+    return 0;
+
+  const auto* osr_rwhv = static_cast<OffScreenRenderWidgetHostView*>(
+      web_contents()->GetRenderWidgetHostView());
+  return osr_rwhv ? osr_rwhv->GetFramePriority() : 0;
+}
+
+void WebContents::SetFrameBudget(int budget_ms) {
+  if (!IsOffScreen())
+    return;
+
+  auto* osr_rwhv = static_cast<OffScreenRenderWidgetHostView*>(
+      web_contents()->GetRenderWidgetHostView());
+  if (osr_rwhv)
+    osr_rwhv->SetFrameBudget(budget_ms);
+}
+
 void WebContents::Invalidate() {
   if (!IsOffScreen())
     return;
@@ -1581,6 +1748,9 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isPainting", &WebContents::IsPainting)
       .SetMethod("setFrameRate", &WebContents::SetFrameRate)
       .SetMethod("getFrameRate", &WebContents::GetFrameRate)
+      .SetMethod("setFramePriority", &WebContents::SetFramePriority)
+      .SetMethod("getFramePriority", &WebContents::GetFramePriority)
+      .SetMethod("setFrameBudget", &WebContents::SetFrameBudget)
       .SetMethod("invalidate", &WebContents::Invalidate)
       .SetMethod("getType", &WebContents::GetType)
       .SetMethod("getWebPreferences", &WebContents::GetWebPreferences)
@@ -1611,6 +1781,10 @@ AtomBrowserContext* WebContents::GetBrowserContext() const {
 
 void WebContents::OnRendererMessage(const base::string16& channel,
                                     const base::ListValue& args) {
+  ScopedHandlerTimer handler_timer;
+  if (ScopedHandlerTimer::ShouldStart())
+    handler_timer.Start(GetIPCHandlerName(args));
+
   // webContents.emit(channel, new Event(), args...);
   Emit(base::UTF16ToUTF8(channel), args);
 }
@@ -1618,6 +1792,10 @@ void WebContents::OnRendererMessage(const base::string16& channel,
 void WebContents::OnRendererMessageSync(const base::string16& channel,
                                         const base::ListValue& args,
                                         IPC::Message* message) {
+  ScopedHandlerTimer handler_timer;
+  if (ScopedHandlerTimer::ShouldStart())
+    handler_timer.Start(GetIPCHandlerName(args));
+
   // webContents.emit(channel, new Event(sender, message), args...);
   EmitWithSender(base::UTF16ToUTF8(channel), web_contents(), message, args);
 }
@@ -172,6 +172,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  void SetFramePriority(int priority);
+  int GetFramePriority() const;
+  void SetFrameBudget(int budget_ms);
   void Invalidate();
 
   // Callback triggered on permission response.
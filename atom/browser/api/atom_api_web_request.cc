@@ -4,7 +4,10 @@
 
 #include "atom/browser/api/atom_api_web_request.h"
 
+#include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/net/atom_network_delegate.h"
@@ -14,6 +17,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "net/http/http_util.h"
 
 using content::BrowserThread;
 
@@ -30,6 +34,63 @@ struct Converter<extensions::URLPattern> {
   }
 };
 
+template<>
+struct Converter<atom::WebRequestRule> {
+  static bool FromV8(v8::Isolate* isolate, v8::Local<v8::Value> val,
+                     atom::WebRequestRule* out) {
+    mate::Dictionary dict;
+    if (!ConvertFromV8(isolate, val, &dict))
+      return false;
+
+    // A rule without patterns applies to every request, so a bad pattern must
+    // not silently turn into that.
+    if (dict.Has("urls") && !dict.Get("urls", &out->url_patterns))
+      return false;
+    dict.Get("cancel", &out->cancel);
+    std::string redirect_url;
+    if (dict.Get("redirectURL", &redirect_url)) {
+      out->redirect_url = GURL(redirect_url);
+      if (!out->redirect_url.is_valid())
+        return false;
+    }
+    return GetHeaders(dict, "addRequestHeaders", &out->add_request_headers) &&
+           GetHeaders(dict, "addResponseHeaders",
+                      &out->add_response_headers) &&
+           GetHeaderNames(dict, "removeRequestHeaders",
+                          &out->remove_request_headers) &&
+           GetHeaderNames(dict, "removeResponseHeaders",
+                          &out->remove_response_headers);
+  }
+
+ private:
+  static bool GetHeaders(const mate::Dictionary& dict,
+                         const std::string& key,
+                         base::StringPairs* out) {
+    std::map<std::string, std::string> headers;
+    if (!dict.Get(key, &headers))
+      return true;
+    for (const auto& header : headers) {
+      if (!net::HttpUtil::IsValidHeaderName(header.first) ||
+          !net::HttpUtil::IsValidHeaderValue(header.second))
+        return false;
+      out->push_back(header);
+    }
+    return true;
+  }
+
+  static bool GetHeaderNames(const mate::Dictionary& dict,
+                             const std::string& key,
+                             std::vector<std::string>* out) {
+    if (!dict.Get(key, out))
+      return true;
+    for (const auto& name : *out) {
+      if (!net::HttpUtil::IsValidHeaderName(name))
+        return false;
+    }
+    return true;
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -59,10 +120,22 @@ void WebRequest::SetResponseListener(mate::Arguments* args) {
 
 template<typename Listener, typename Method, typename Event>
 void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
-  // { urls }.
+  // { urls, fields }.
   URLPatterns patterns;
+  std::set<std::string> field_names;
   mate::Dictionary dict;
-  args->GetNext(&dict) && dict.Get("urls", &patterns);
+  if (args->GetNext(&dict)) {
+    dict.Get("urls", &patterns);
+    dict.Get("fields", &field_names);
+  }
+
+  AtomNetworkDelegate::DetailsFields fields;
+  std::string unknown_name;
+  if (!AtomNetworkDelegate::ParseDetailsFields(field_names, &fields,
+                                               &unknown_name)) {
+    args->ThrowError("Unknown details field: " + unknown_name);
+    return;
+  }
 
   // Function or null.
   v8::Local<v8::Value> value;
@@ -76,7 +149,23 @@ void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
   auto delegate = browser_context_->network_delegate();
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
                           base::Bind(method, base::Unretained(delegate), type,
-                                     patterns, listener));
+                                     patterns, fields, listener));
+}
+
+void WebRequest::SetRules(mate::Arguments* args) {
+  // Array of rules or null.
+  std::vector<WebRequestRule> rules;
+  v8::Local<v8::Value> value;
+  if (!args->GetNext(&rules) &&
+      !(args->GetNext(&value) && value->IsNull())) {
+    args->ThrowError("Must pass null or an Array of valid rules");
+    return;
+  }
+
+  auto delegate = browser_context_->network_delegate();
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+                          base::Bind(&AtomNetworkDelegate::SetRulesInIO,
+                                     base::Unretained(delegate), rules));
 }
 
 // static
@@ -114,7 +203,8 @@ void WebRequest::BuildPrototype(v8::Isolate* isolate,
                     AtomNetworkDelegate::kOnCompleted>)
       .SetMethod("onErrorOccurred",
                  &WebRequest::SetSimpleListener<
-                    AtomNetworkDelegate::kOnErrorOccurred>);
+                    AtomNetworkDelegate::kOnErrorOccurred>)
+      .SetMethod("setRules", &WebRequest::SetRules);
 }
 
 }  // namespace api
@@ -4,6 +4,9 @@
 
 #include "atom/browser/atom_blob_reader.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "content/browser/blob_storage/chrome_blob_storage_context.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/io_buffer.h"
@@ -44,6 +47,41 @@ void RunCallbackInUI(
   }
 }
 
+// Releases the IOBuffer owning the memory of a garbage collected Buffer.
+void ReleaseIOBuffer(char* data, void* hint) {
+  static_cast<net::IOBuffer*>(hint)->Release();
+}
+
+void RunChunkCallbackInUI(
+    const AtomBlobReader::CompletionCallback& callback,
+    scoped_refptr<net::IOBuffer> chunk,
+    int size) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  if (chunk) {
+    // The Buffer uses the memory of the IOBuffer, which is kept alive until
+    // the Buffer is garbage collected.
+    chunk->AddRef();
+    v8::Local<v8::Value> buffer = node::Buffer::New(isolate,
+        chunk->data(), static_cast<size_t>(size), &ReleaseIOBuffer,
+        chunk.get()).ToLocalChecked();
+    callback.Run(buffer);
+  } else {
+    callback.Run(v8::Null(isolate));
+  }
+}
+
+void PostChunkToUI(
+    const AtomBlobReader::CompletionCallback& callback,
+    scoped_refptr<net::IOBuffer> chunk,
+    int size) {
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&RunChunkCallbackInUI, callback, chunk, size));
+}
+
 }  // namespace
 
 AtomBlobReader::AtomBlobReader(
@@ -61,24 +99,62 @@ void AtomBlobReader::StartReading(
     const AtomBlobReader::CompletionCallback& completion_callback) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
-  auto blob_data_handle =
-      blob_context_->context()->GetBlobDataFromUUID(uuid);
+  auto blob_reader = CreateReader(uuid);
   auto callback = base::Bind(&RunCallbackInUI,
                              completion_callback);
-  if (!blob_data_handle) {
+  if (!blob_reader) {
     BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
         base::Bind(callback, nullptr, 0));
     return;
   }
 
-  auto blob_reader = blob_data_handle->CreateReader(
-      file_system_context_.get(),
-      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get());
   BlobReadHelper* blob_read_helper =
       new BlobReadHelper(std::move(blob_reader), callback);
   blob_read_helper->Read();
 }
 
+void AtomBlobReader::OpenStream(int id,
+                                const std::string& uuid,
+                                int64_t offset,
+                                int64_t length) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  streams_[id].reset(new BlobStream(CreateReader(uuid), offset, length));
+}
+
+void AtomBlobReader::ReadStream(
+    int id,
+    int max_bytes,
+    const AtomBlobReader::CompletionCallback& completion_callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  auto callback = base::Bind(&PostChunkToUI, completion_callback);
+  auto it = streams_.find(id);
+  if (it == streams_.end()) {
+    callback.Run(nullptr, 0);
+    return;
+  }
+  it->second->Read(max_bytes, callback);
+}
+
+void AtomBlobReader::CloseStream(int id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  streams_.erase(id);
+}
+
+std::unique_ptr<storage::BlobReader> AtomBlobReader::CreateReader(
+    const std::string& uuid) {
+  auto blob_data_handle =
+      blob_context_->context()->GetBlobDataFromUUID(uuid);
+  if (!blob_data_handle)
+    return nullptr;
+
+  return blob_data_handle->CreateReader(
+      file_system_context_.get(),
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get());
+}
+
 AtomBlobReader::BlobReadHelper::BlobReadHelper(
     std::unique_ptr<storage::BlobReader> blob_reader,
     const BlobReadHelper::CompletionCallback& callback)
@@ -103,19 +179,19 @@ void AtomBlobReader::BlobReadHelper::DidCalculateSize(int result) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
   if (result != net::OK) {
-    DidReadBlobData(nullptr, 0);
+    DidReadBlobData(0);
     return;
   }
 
   uint64_t total_size = blob_reader_->total_size();
   int bytes_read = 0;
-  scoped_refptr<net::IOBuffer> blob_data =
-      new net::IOBuffer(static_cast<size_t>(total_size));
+  // The blob is read directly into the memory that is handed to the Buffer.
+  blob_data_.reset(new char[total_size]);
+  blob_buffer_ = new net::WrappedIOBuffer(blob_data_.get());
   auto callback = base::Bind(&AtomBlobReader::BlobReadHelper::DidReadBlobData,
-                             base::Unretained(this),
-                             base::RetainedRef(blob_data));
+                             base::Unretained(this));
   storage::BlobReader::Status read_status = blob_reader_->Read(
-      blob_data.get(),
+      blob_buffer_.get(),
       total_size,
       &bytes_read,
       callback);
@@ -123,16 +199,128 @@ void AtomBlobReader::BlobReadHelper::DidCalculateSize(int result) {
     callback.Run(bytes_read);
 }
 
-void AtomBlobReader::BlobReadHelper::DidReadBlobData(
-    const scoped_refptr<net::IOBuffer>& blob_data,
-    int size) {
+void AtomBlobReader::BlobReadHelper::DidReadBlobData(int size) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
-  char* data = new char[size];
-  memcpy(data, blob_data->data(), size);
+  if (!blob_data_ || size < 0)
+    size = 0;
+  char* data = blob_data_ ? blob_data_.release() : new char[0];
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
       base::Bind(completion_callback_, data, size));
   delete this;
 }
 
+AtomBlobReader::BlobStream::BlobStream(
+    std::unique_ptr<storage::BlobReader> blob_reader,
+    int64_t offset,
+    int64_t length)
+    : state_(State::CALCULATING_SIZE),
+      offset_(offset),
+      length_(length),
+      pending_size_(0),
+      blob_reader_(std::move(blob_reader)) {
+  if (!blob_reader_) {
+    state_ = State::FAILED;
+    return;
+  }
+
+  storage::BlobReader::Status size_status = blob_reader_->CalculateSize(
+      base::Bind(&AtomBlobReader::BlobStream::DidCalculateSize,
+                 base::Unretained(this)));
+  if (size_status == storage::BlobReader::Status::DONE)
+    DidCalculateSize(net::OK);
+  else if (size_status == storage::BlobReader::Status::NET_ERROR)
+    DidCalculateSize(blob_reader_->net_error());
+}
+
+AtomBlobReader::BlobStream::~BlobStream() {
+}
+
+void AtomBlobReader::BlobStream::Read(int max_bytes,
+                                      const ChunkCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  DCHECK(pending_callback_.is_null());
+
+  pending_size_ = max_bytes;
+  pending_callback_ = callback;
+  if (state_ == State::READY)
+    StartRead();
+  else if (state_ == State::FAILED)
+    Fail();
+}
+
+void AtomBlobReader::BlobStream::DidCalculateSize(int result) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  uint64_t total_size = blob_reader_->total_size();
+  if (result != net::OK || offset_ < 0 ||
+      static_cast<uint64_t>(offset_) > total_size) {
+    Fail();
+    return;
+  }
+
+  uint64_t length = total_size - offset_;
+  if (length_ >= 0)
+    length = std::min(length, static_cast<uint64_t>(length_));
+  if (blob_reader_->SetReadRange(offset_, length) !=
+          storage::BlobReader::Status::DONE) {
+    Fail();
+    return;
+  }
+
+  state_ = State::READY;
+  if (!pending_callback_.is_null())
+    StartRead();
+}
+
+void AtomBlobReader::BlobStream::StartRead() {
+  int size = static_cast<int>(std::min(
+      static_cast<uint64_t>(std::max(pending_size_, 0)),
+      blob_reader_->remaining_bytes()));
+  chunk_ = new net::IOBuffer(size);
+  if (size == 0) {
+    // End of the stream.
+    DidRead(0);
+    return;
+  }
+
+  int bytes_read = 0;
+  storage::BlobReader::Status read_status = blob_reader_->Read(
+      chunk_.get(),
+      size,
+      &bytes_read,
+      base::Bind(&AtomBlobReader::BlobStream::DidRead,
+                 base::Unretained(this)));
+  if (read_status == storage::BlobReader::Status::DONE)
+    DidRead(bytes_read);
+  else if (read_status == storage::BlobReader::Status::NET_ERROR)
+    Fail();
+}
+
+void AtomBlobReader::BlobStream::DidRead(int bytes_read) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  if (bytes_read < 0) {
+    Fail();
+    return;
+  }
+
+  scoped_refptr<net::IOBuffer> chunk;
+  chunk.swap(chunk_);
+  ChunkCallback callback = pending_callback_;
+  pending_callback_.Reset();
+  callback.Run(chunk, bytes_read);
+}
+
+void AtomBlobReader::BlobStream::Fail() {
+  state_ = State::FAILED;
+  chunk_ = nullptr;
+  if (pending_callback_.is_null())
+    return;
+
+  ChunkCallback callback = pending_callback_;
+  pending_callback_.Reset();
+  callback.Run(nullptr, 0);
+}
+
 }  // namespace atom
@@ -5,9 +5,12 @@
 #ifndef ATOM_BROWSER_ATOM_BLOB_READER_H_
 #define ATOM_BROWSER_ATOM_BLOB_READER_H_
 
+#include <map>
+#include <memory>
 #include <string>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
 
 namespace content {
 class ChromeBlobStorageContext;
@@ -45,6 +48,20 @@ class AtomBlobReader {
       const std::string& uuid,
       const AtomBlobReader::CompletionCallback& callback);
 
+  // Reads the blob of |uuid| chunk by chunk, starting at |offset| and reading
+  // |length| bytes, or up to the end when |length| is negative. The streams
+  // are identified by |id|, which is chosen by the caller.
+  void OpenStream(int id,
+                  const std::string& uuid,
+                  int64_t offset,
+                  int64_t length);
+  // Reads up to |max_bytes| bytes of the stream of |id|, |callback| receives
+  // an empty buffer at the end of the stream and null on failure.
+  void ReadStream(int id,
+                  int max_bytes,
+                  const AtomBlobReader::CompletionCallback& callback);
+  void CloseStream(int id);
+
  private:
   // A self-destroyed helper class to read the blob data.
   // Must be accessed on IO thread.
@@ -60,15 +77,66 @@ class AtomBlobReader {
 
    private:
     void DidCalculateSize(int result);
-    void DidReadBlobData(const scoped_refptr<net::IOBuffer>& blob_data,
-                         int bytes_read);
+    void DidReadBlobData(int bytes_read);
 
+    // Passed to the callback after reading.
+    std::unique_ptr<char[]> blob_data_;
+    scoped_refptr<net::IOBuffer> blob_buffer_;
     std::unique_ptr<storage::BlobReader> blob_reader_;
     BlobReadHelper::CompletionCallback completion_callback_;
 
     DISALLOW_COPY_AND_ASSIGN(BlobReadHelper);
   };
 
+  // Reads a range of a blob into separate chunks.
+  // Must be accessed on IO thread.
+  class BlobStream {
+   public:
+    // Receives the chunk, null on failure, and its size.
+    using ChunkCallback =
+        base::Callback<void(scoped_refptr<net::IOBuffer>, int)>;
+
+    // A null |blob_reader| makes all reads fail.
+    BlobStream(std::unique_ptr<storage::BlobReader> blob_reader,
+               int64_t offset,
+               int64_t length);
+    ~BlobStream();
+
+    // Only one read can be pending at a time.
+    void Read(int max_bytes, const ChunkCallback& callback);
+
+   private:
+    enum class State {
+      CALCULATING_SIZE,
+      READY,
+      FAILED,
+    };
+
+    void DidCalculateSize(int result);
+    void StartRead();
+    void DidRead(int bytes_read);
+    void Fail();
+
+    State state_;
+    int64_t offset_;
+    int64_t length_;
+
+    int pending_size_;
+    ChunkCallback pending_callback_;
+    // The chunk being read, which is passed to the callback. A pending read of
+    // a file keeps its own reference, so the memory outlives the stream when
+    // it is closed during the read.
+    scoped_refptr<net::IOBuffer> chunk_;
+
+    std::unique_ptr<storage::BlobReader> blob_reader_;
+
+    DISALLOW_COPY_AND_ASSIGN(BlobStream);
+  };
+
+  std::unique_ptr<storage::BlobReader> CreateReader(const std::string& uuid);
+
+  std::map<int, std::unique_ptr<BlobStream>> streams_;
+
   scoped_refptr<content::ChromeBlobStorageContext> blob_context_;
   scoped_refptr<storage::FileSystemContext> file_system_context_;
 
@@ -39,6 +39,7 @@
 #include "content/public/common/url_constants.h"
 #include "content/public/common/user_agent.h"
 #include "net/ftp/ftp_network_layer.h"
+#include "net/http/http_cache.h"
 #include "net/url_request/data_protocol_handler.h"
 #include "net/url_request/ftp_protocol_handler.h"
 #include "net/url_request/url_request_context.h"
@@ -94,7 +95,16 @@ AtomBrowserContext::AtomBrowserContext(const std::string& partition,
 
   // Read options.
   use_cache_ = true;
-  options.GetBoolean("cache", &use_cache_);
+  use_memory_cache_ = false;
+  // The string form is validated by session.fromPartition to be either
+  // "memory" or "disk".
+  std::string cache_type;
+  if (options.GetString("cache", &cache_type))
+    use_memory_cache_ = cache_type == "memory";
+  else
+    options.GetBoolean("cache", &use_cache_);
+  max_cache_bytes_ = 0;
+  options.GetInteger("maxCacheBytes", &max_cache_bytes_);
 
   // Initialize Pref Registry in brightray.
   InitPrefs();
@@ -168,8 +178,16 @@ AtomBrowserContext::CreateHttpCacheBackendFactory(
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
   if (!use_cache_ || command_line->HasSwitch(switches::kDisableHttpCache))
     return new NoCacheBackend;
-  else
-    return brightray::BrowserContext::CreateHttpCacheBackendFactory(base_path);
+  // The memory backend evicts the least recently used entries once it holds
+  // more than |max_cache_bytes_|.
+  if (use_memory_cache_)
+    return net::HttpCache::DefaultBackend::InMemory(max_cache_bytes_);
+  if (max_cache_bytes_ > 0)
+    return new net::HttpCache::DefaultBackend(
+        net::DISK_CACHE, net::CACHE_BACKEND_DEFAULT,
+        base_path.Append(FILE_PATH_LITERAL("Cache")), max_cache_bytes_,
+        BrowserThread::GetTaskRunnerForThread(BrowserThread::CACHE));
+  return brightray::BrowserContext::CreateHttpCacheBackendFactory(base_path);
 }
 
 content::DownloadManagerDelegate*
@@ -73,6 +73,9 @@ class AtomBrowserContext : public brightray::BrowserContext {
   std::unique_ptr<AtomCTDelegate> ct_delegate_;
   std::string user_agent_;
   bool use_cache_;
+  bool use_memory_cache_;
+  // The size limit of the HTTP cache, 0 lets the backend choose one.
+  int max_cache_bytes_;
 
   // Managed by brightray::BrowserContext.
   AtomNetworkDelegate* network_delegate_;
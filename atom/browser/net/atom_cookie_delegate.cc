@@ -22,20 +22,40 @@ void AtomCookieDelegate::RemoveObserver(Observer* observer) {
   observers_.RemoveObserver(observer);
 }
 
-void AtomCookieDelegate::NotifyObservers(
-  const net::CanonicalCookie& cookie, bool removed, ChangeCause cause) {
-  FOR_EACH_OBSERVER(Observer,
-                    observers_,
-                    OnCookieChanged(cookie, removed, cause));
+void AtomCookieDelegate::FlushChanges() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  std::vector<Change> changes;
+  changes.swap(pending_changes_);
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&AtomCookieDelegate::NotifyObservers, this, changes));
+}
+
+void AtomCookieDelegate::NotifyObservers(const std::vector<Change>& changes) {
+  for (const auto& change : changes) {
+    FOR_EACH_OBSERVER(Observer,
+                      observers_,
+                      OnCookieChanged(change.cookie, change.removed,
+                                      change.cause));
+  }
+  FOR_EACH_OBSERVER(Observer, observers_, OnCookiesChanged(changes));
 }
 
 void AtomCookieDelegate::OnCookieChanged(
     const net::CanonicalCookie& cookie, bool removed, ChangeCause cause) {
-  content::BrowserThread::PostTask(
-      content::BrowserThread::UI,
-      FROM_HERE,
-      base::Bind(&AtomCookieDelegate::NotifyObservers,
-                 this, cookie, removed, cause));
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (cookie_index_.is_loaded())
+    cookie_index_.OnCookieChanged(cookie, removed);
+
+  // Changes made in the same task, e.g. by cookies.setMany, are posted to the
+  // UI thread together.
+  if (pending_changes_.empty())
+    content::BrowserThread::PostTask(
+        content::BrowserThread::IO,
+        FROM_HERE,
+        base::Bind(&AtomCookieDelegate::FlushChanges, this));
+  pending_changes_.push_back({ cookie, removed, cause });
 }
 
 }  // namespace atom
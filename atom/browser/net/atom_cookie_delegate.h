@@ -5,6 +5,9 @@
 #ifndef ATOM_BROWSER_NET_ATOM_COOKIE_DELEGATE_H_
 #define ATOM_BROWSER_NET_ATOM_COOKIE_DELEGATE_H_
 
+#include <vector>
+
+#include "atom/browser/net/cookie_index.h"
 #include "base/observer_list.h"
 #include "net/cookies/cookie_monster.h"
 
@@ -15,11 +18,20 @@ class AtomCookieDelegate : public net::CookieMonsterDelegate {
   AtomCookieDelegate();
   ~AtomCookieDelegate() override;
 
+  struct Change {
+    net::CanonicalCookie cookie;
+    bool removed;
+    ChangeCause cause;
+  };
+
   class Observer {
    public:
     virtual void OnCookieChanged(const net::CanonicalCookie& cookie,
                                  bool removed,
                                  ChangeCause cause) {}
+    // Called after OnCookieChanged with all the changes made in one task on
+    // the IO thread.
+    virtual void OnCookiesChanged(const std::vector<Change>& changes) {}
    protected:
     virtual ~Observer() {}
   };
@@ -27,6 +39,9 @@ class AtomCookieDelegate : public net::CookieMonsterDelegate {
   void AddObserver(Observer* observer);
   void RemoveObserver(Observer* observer);
 
+  // The index of the cookies in the store, only usable on the IO thread.
+  CookieIndex* cookie_index() { return &cookie_index_; }
+
   // net::CookieMonsterDelegate:
   void OnCookieChanged(const net::CanonicalCookie& cookie,
                        bool removed,
@@ -35,10 +50,13 @@ class AtomCookieDelegate : public net::CookieMonsterDelegate {
 
  private:
   base::ObserverList<Observer> observers_;
+  CookieIndex cookie_index_;
 
-  void NotifyObservers(const net::CanonicalCookie& cookie,
-                       bool removed,
-                       ChangeCause cause);
+  // Changes waiting to be posted to the UI thread, only used on IO thread.
+  std::vector<Change> pending_changes_;
+
+  void FlushChanges();
+  void NotifyObservers(const std::vector<Change>& changes);
 
   DISALLOW_COPY_AND_ASSIGN(AtomCookieDelegate);
 };
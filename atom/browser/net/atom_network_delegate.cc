@@ -58,30 +58,86 @@ void RunResponseListener(
 
 // Test whether the URL of |request| matches |patterns|.
 bool MatchesFilterCondition(net::URLRequest* request,
-                            const URLPatterns& patterns) {
-  if (patterns.empty())
+                            const URLPatternMatcher& patterns) {
+  if (patterns.is_empty())
     return true;
 
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(request->url()))
-      return true;
+  return patterns.MatchesURL(request->url());
+}
+
+// Bits of the fields in the details object.
+enum DetailsField : uint32_t {
+  kFieldId = 1 << 0,
+  kFieldUrl = 1 << 1,
+  kFieldMethod = 1 << 2,
+  kFieldReferrer = 1 << 3,
+  kFieldUploadData = 1 << 4,
+  kFieldTimestamp = 1 << 5,
+  kFieldResourceType = 1 << 6,
+  kFieldRequestHeaders = 1 << 7,
+  kFieldResponseHeaders = 1 << 8,
+  kFieldStatusLine = 1 << 9,
+  kFieldStatusCode = 1 << 10,
+  kFieldRedirectURL = 1 << 11,
+  kFieldIp = 1 << 12,
+  kFieldFromCache = 1 << 13,
+  kFieldError = 1 << 14,
+};
+
+const struct {
+  const char* name;
+  DetailsField field;
+} kDetailsFields[] = {
+  { "id", kFieldId },
+  { "url", kFieldUrl },
+  { "method", kFieldMethod },
+  { "referrer", kFieldReferrer },
+  { "uploadData", kFieldUploadData },
+  { "timestamp", kFieldTimestamp },
+  { "resourceType", kFieldResourceType },
+  { "requestHeaders", kFieldRequestHeaders },
+  { "responseHeaders", kFieldResponseHeaders },
+  { "statusLine", kFieldStatusLine },
+  { "statusCode", kFieldStatusCode },
+  { "redirectURL", kFieldRedirectURL },
+  { "ip", kFieldIp },
+  { "fromCache", kFieldFromCache },
+  { "error", kFieldError },
+};
+
+// Overloaded by multiple types to fill the |details| object, only the fields
+// in |fields| are filled.
+void ToDictionary(base::DictionaryValue* details,
+                  AtomNetworkDelegate::DetailsFields fields,
+                  net::URLRequest* request) {
+  uint32_t request_fields = 0;
+  if (fields & kFieldMethod)
+    request_fields |= kRequestDetailsMethod;
+  if (fields & kFieldUrl)
+    request_fields |= kRequestDetailsUrl;
+  if (fields & kFieldReferrer)
+    request_fields |= kRequestDetailsReferrer;
+  if (fields & kFieldUploadData)
+    request_fields |= kRequestDetailsUploadData;
+  FillRequestDetails(details, request, request_fields);
+  if (fields & kFieldId)
+    details->SetInteger("id", request->identifier());
+  if (fields & kFieldTimestamp)
+    details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
+  if (fields & kFieldResourceType) {
+    auto info = content::ResourceRequestInfo::ForRequest(request);
+    details->SetString("resourceType",
+                       info ? ResourceTypeToString(info->GetResourceType())
+                            : "other");
   }
-  return false;
-}
-
-// Overloaded by multiple types to fill the |details| object.
-void ToDictionary(base::DictionaryValue* details, net::URLRequest* request) {
-  FillRequestDetails(details, request);
-  details->SetInteger("id", request->identifier());
-  details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
-  auto info = content::ResourceRequestInfo::ForRequest(request);
-  details->SetString("resourceType",
-                     info ? ResourceTypeToString(info->GetResourceType())
-                          : "other");
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  AtomNetworkDelegate::DetailsFields fields,
                   const net::HttpRequestHeaders& headers) {
+  if (!(fields & kFieldRequestHeaders))
+    return;
+
   std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
   net::HttpRequestHeaders::Iterator it(headers);
   while (it.GetNext())
@@ -90,59 +146,78 @@ void ToDictionary(base::DictionaryValue* details,
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  AtomNetworkDelegate::DetailsFields fields,
                   const net::HttpResponseHeaders* headers) {
   if (!headers)
     return;
 
-  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
-  size_t iter = 0;
-  std::string key;
-  std::string value;
-  while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
-    if (dict->HasKey(key)) {
-      base::ListValue* values = nullptr;
-      if (dict->GetList(key, &values))
+  if (fields & kFieldResponseHeaders) {
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    size_t iter = 0;
+    std::string key;
+    std::string value;
+    while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
+      if (dict->HasKey(key)) {
+        base::ListValue* values = nullptr;
+        if (dict->GetList(key, &values))
+          values->AppendString(value);
+      } else {
+        std::unique_ptr<base::ListValue> values(new base::ListValue);
         values->AppendString(value);
-    } else {
-      std::unique_ptr<base::ListValue> values(new base::ListValue);
-      values->AppendString(value);
-      dict->Set(key, std::move(values));
+        dict->Set(key, std::move(values));
+      }
     }
+    details->Set("responseHeaders", std::move(dict));
   }
-  details->Set("responseHeaders", std::move(dict));
-  details->SetString("statusLine", headers->GetStatusLine());
-  details->SetInteger("statusCode", headers->response_code());
+  if (fields & kFieldStatusLine)
+    details->SetString("statusLine", headers->GetStatusLine());
+  if (fields & kFieldStatusCode)
+    details->SetInteger("statusCode", headers->response_code());
 }
 
-void ToDictionary(base::DictionaryValue* details, const GURL& location) {
-  details->SetString("redirectURL", location.spec());
+void ToDictionary(base::DictionaryValue* details,
+                  AtomNetworkDelegate::DetailsFields fields,
+                  const GURL& location) {
+  if (fields & kFieldRedirectURL)
+    details->SetString("redirectURL", location.spec());
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  AtomNetworkDelegate::DetailsFields fields,
                   const net::HostPortPair& host_port) {
-  if (host_port.host().empty())
+  if ((fields & kFieldIp) && host_port.host().empty())
     details->SetString("ip", host_port.host());
 }
 
-void ToDictionary(base::DictionaryValue* details, bool from_cache) {
-  details->SetBoolean("fromCache", from_cache);
+void ToDictionary(base::DictionaryValue* details,
+                  AtomNetworkDelegate::DetailsFields fields,
+                  bool from_cache) {
+  if (fields & kFieldFromCache)
+    details->SetBoolean("fromCache", from_cache);
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  AtomNetworkDelegate::DetailsFields fields,
                   const net::URLRequestStatus& status) {
-  details->SetString("error", net::ErrorToString(status.error()));
+  if (fields & kFieldError)
+    details->SetString("error", net::ErrorToString(status.error()));
 }
 
 // Helper function to fill |details| with arbitrary |args|.
 template<typename Arg>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg) {
-  ToDictionary(details, arg);
+void FillDetailsObject(base::DictionaryValue* details,
+                       AtomNetworkDelegate::DetailsFields fields,
+                       Arg arg) {
+  ToDictionary(details, fields, arg);
 }
 
 template<typename Arg, typename... Args>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg, Args... args) {
-  ToDictionary(details, arg);
-  FillDetailsObject(details, args...);
+void FillDetailsObject(base::DictionaryValue* details,
+                       AtomNetworkDelegate::DetailsFields fields,
+                       Arg arg,
+                       Args... args) {
+  ToDictionary(details, fields, arg);
+  FillDetailsObject(details, fields, args...);
 }
 
 // Fill the native types with the result from the response object.
@@ -196,6 +271,36 @@ void ReadFromResponseObject(const base::DictionaryValue& response,
 
 }  // namespace
 
+AtomNetworkDelegate::CacheStats::CacheStats()
+    : hits(0), misses(0), bytes_from_cache(0), bytes_from_network(0) {
+}
+
+// static
+bool AtomNetworkDelegate::ParseDetailsFields(
+    const std::set<std::string>& names,
+    DetailsFields* fields,
+    std::string* unknown_name) {
+  if (names.empty()) {
+    *fields = kAllDetailsFields;
+    return true;
+  }
+
+  *fields = 0;
+  for (const std::string& name : names) {
+    DetailsFields field = 0;
+    for (const auto& it : kDetailsFields) {
+      if (name == it.name)
+        field = it.field;
+    }
+    if (!field) {
+      *unknown_name = name;
+      return false;
+    }
+    *fields |= field;
+  }
+  return true;
+}
+
 AtomNetworkDelegate::AtomNetworkDelegate() {
 }
 
@@ -205,21 +310,30 @@ AtomNetworkDelegate::~AtomNetworkDelegate() {
 void AtomNetworkDelegate::SetSimpleListenerInIO(
     SimpleEvent type,
     const URLPatterns& patterns,
+    DetailsFields fields,
     const SimpleListener& callback) {
   if (callback.is_null())
     simple_listeners_.erase(type);
   else
-    simple_listeners_[type] = { patterns, callback };
+    simple_listeners_[type] = { URLPatternMatcher(patterns), fields,
+                                callback };
 }
 
 void AtomNetworkDelegate::SetResponseListenerInIO(
     ResponseEvent type,
     const URLPatterns& patterns,
+    DetailsFields fields,
     const ResponseListener& callback) {
   if (callback.is_null())
     response_listeners_.erase(type);
   else
-    response_listeners_[type] = { patterns, callback };
+    response_listeners_[type] = { URLPatternMatcher(patterns), fields,
+                                  callback };
+}
+
+void AtomNetworkDelegate::SetRulesInIO(
+    const std::vector<WebRequestRule>& rules) {
+  rules_ = WebRequestRules(rules);
 }
 
 void AtomNetworkDelegate::SetDevToolsNetworkEmulationClientId(
@@ -232,6 +346,13 @@ int AtomNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  if (!rules_.empty()) {
+    int result = rules_.OnBeforeRequest(request->url(), new_url);
+    // The listener is not asked when a rule has decided.
+    if (result != net::OK || !new_url->is_empty())
+      return result;
+  }
+
   if (!ContainsKey(response_listeners_, kOnBeforeRequest))
     return brightray::NetworkDelegate::OnBeforeURLRequest(
         request, callback, new_url);
@@ -253,6 +374,8 @@ int AtomNetworkDelegate::OnBeforeStartTransaction(
     headers->SetHeader(
         DevToolsNetworkTransaction::kDevToolsEmulateNetworkConditionsClientId,
         client_id);
+  if (!rules_.empty())
+    rules_.OnBeforeSendHeaders(request->url(), headers);
   if (!ContainsKey(response_listeners_, kOnBeforeSendHeaders))
     return brightray::NetworkDelegate::OnBeforeStartTransaction(
         request, callback, headers);
@@ -278,6 +401,13 @@ int AtomNetworkDelegate::OnHeadersReceived(
     const net::HttpResponseHeaders* original,
     scoped_refptr<net::HttpResponseHeaders>* override,
     GURL* allowed) {
+  if (!rules_.empty()) {
+    rules_.OnHeadersReceived(request->url(), original, override);
+    // The listener sees the headers changed by the rules.
+    if (override->get())
+      original = override->get();
+  }
+
   if (!ContainsKey(response_listeners_, kOnHeadersReceived))
     return brightray::NetworkDelegate::OnHeadersReceived(
         request, callback, original, override, allowed);
@@ -315,6 +445,7 @@ void AtomNetworkDelegate::OnResponseStarted(net::URLRequest* request) {
 void AtomNetworkDelegate::OnCompleted(net::URLRequest* request, bool started) {
   // OnCompleted may happen before other events.
   callbacks_.erase(request->identifier());
+  UpdateCacheStats(request);
 
   if (request->status().status() == net::URLRequestStatus::FAILED ||
       request->status().status() == net::URLRequestStatus::CANCELED) {
@@ -342,6 +473,22 @@ void AtomNetworkDelegate::OnURLRequestDestroyed(net::URLRequest* request) {
   callbacks_.erase(request->identifier());
 }
 
+void AtomNetworkDelegate::UpdateCacheStats(net::URLRequest* request) {
+  if (!request->url().SchemeIsHTTPOrHTTPS() ||
+      request->status().status() != net::URLRequestStatus::SUCCESS)
+    return;
+
+  if (request->was_cached()) {
+    ++cache_stats_.hits;
+    cache_stats_.bytes_from_cache +=
+        request->received_response_content_length();
+  } else {
+    ++cache_stats_.misses;
+  }
+  // Revalidated responses are served from the cache but still go to network.
+  cache_stats_.bytes_from_network += request->GetTotalReceivedBytes();
+}
+
 void AtomNetworkDelegate::OnErrorOccurred(
     net::URLRequest* request, bool started) {
   if (!ContainsKey(simple_listeners_, kOnErrorOccurred)) {
@@ -365,7 +512,7 @@ int AtomNetworkDelegate::HandleResponseEvent(
     return net::OK;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
 
   // The |request| could be destroyed before the |callback| is called.
   callbacks_[request->identifier()] = callback;
@@ -388,7 +535,7 @@ void AtomNetworkDelegate::HandleSimpleEvent(
     return;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
 
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
@@ -8,25 +8,21 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "atom/browser/net/url_pattern_matcher.h"
+#include "atom/browser/net/web_request_rules.h"
 #include "base/callback.h"
 #include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "brightray/browser/network_delegate.h"
 #include "content/public/browser/resource_request_info.h"
-#include "extensions/common/url_pattern.h"
 #include "net/base/net_errors.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 
-namespace extensions {
-class URLPattern;
-}
-
 namespace atom {
 
-using URLPatterns = std::set<extensions::URLPattern>;
-
 const char* ResourceTypeToString(content::ResourceType type);
 
 class AtomNetworkDelegate : public brightray::NetworkDelegate {
@@ -50,28 +46,58 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
     kOnHeadersReceived,
   };
 
+  // Bit set of the fields a listener wants in the details object.
+  using DetailsFields = uint32_t;
+  static const DetailsFields kAllDetailsFields = ~0u;
+
   struct SimpleListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
+    DetailsFields fields;
     SimpleListener listener;
   };
 
   struct ResponseListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
+    DetailsFields fields;
     ResponseListener listener;
   };
 
+  // How the completed HTTP requests were served.
+  struct CacheStats {
+    CacheStats();
+
+    int64_t hits;
+    int64_t misses;
+    // Response bytes read from the cache.
+    int64_t bytes_from_cache;
+    // Bytes received from the network, including headers.
+    int64_t bytes_from_network;
+  };
+
   AtomNetworkDelegate();
   ~AtomNetworkDelegate() override;
 
+  // Converts the names of the fields a listener wants, an empty |names|
+  // means all fields. Returns false and sets |unknown_name| when a name is
+  // not a field of the details object.
+  static bool ParseDetailsFields(const std::set<std::string>& names,
+                                 DetailsFields* fields,
+                                 std::string* unknown_name);
+
   void SetSimpleListenerInIO(SimpleEvent type,
                              const URLPatterns& patterns,
+                             DetailsFields fields,
                              const SimpleListener& callback);
   void SetResponseListenerInIO(ResponseEvent type,
                                const URLPatterns& patterns,
+                               DetailsFields fields,
                                const ResponseListener& callback);
+  void SetRulesInIO(const std::vector<WebRequestRule>& rules);
 
   void SetDevToolsNetworkEmulationClientId(const std::string& client_id);
 
+  const CacheStats& cache_stats() const { return cache_stats_; }
+
  protected:
   // net::NetworkDelegate:
   int OnBeforeURLRequest(net::URLRequest* request,
@@ -96,6 +122,7 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
 
  private:
   void OnErrorOccurred(net::URLRequest* request, bool started);
+  void UpdateCacheStats(net::URLRequest* request);
 
   template<typename...Args>
   void HandleSimpleEvent(SimpleEvent type,
@@ -120,6 +147,12 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
   std::map<uint64_t, net::CompletionCallback> callbacks_;
 
+  // Applied before the listeners are asked.
+  WebRequestRules rules_;
+
+  // Only used on IO thread.
+  CacheStats cache_stats_;
+
   base::Lock lock_;
 
   // Client id for devtools network emulation.
@@ -4,6 +4,8 @@
 // found in the LICENSE file.
 
 #include "atom/browser/net/atom_url_request.h"
+#include <algorithm>
+#include <deque>
 #include <string>
 #include "atom/browser/api/atom_api_url_request.h"
 #include "atom/browser/atom_browser_context.h"
@@ -11,10 +13,25 @@
 #include "content/public/browser/browser_thread.h"
 #include "net/base/elements_upload_data_stream.h"
 #include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
 #include "net/base/upload_bytes_element_reader.h"
+#include "net/base/upload_data_stream.h"
 
 namespace {
-const int kBufferSize = 4096;
+
+// The size of the buffer responses are read into adapts to how fast data
+// arrives, within these bounds.
+const int kMinBufferSize = 64 * 1024;
+const int kMaxBufferSize = 1024 * 1024;
+
+// Data smaller than this fraction of the buffer it was read into is copied,
+// so a small chunk kept by JavaScript does not pin a whole buffer.
+const int kMinSliceFraction = 8;
+
+// Uploaded chunks are kept so a redirect or an authentication retry can send
+// them again, until the response starts or they exceed this size.
+const int64_t kMaxRetainedUploadSize = 1024 * 1024;
+
 }  // namespace
 
 namespace atom {
@@ -41,12 +58,217 @@ class UploadOwnedIOBufferElementReader : public net::UploadBytesElementReader {
   DISALLOW_COPY_AND_ASSIGN(UploadOwnedIOBufferElementReader);
 };
 
+// A chunked upload stream that reads straight from the buffers passed to
+// Write, unlike net::ChunkedUploadDataStream which copies them. Uploaded
+// buffers are kept for rewinding until ReleaseSentChunks() is called or they
+// exceed kMaxRetainedUploadSize, after which the stream can not be rewound.
+class ChunkedUploadStream : public net::UploadDataStream {
+ public:
+  // Called with the size of every buffer that has been uploaded.
+  using ConsumedCallback = base::Callback<void(int)>;
+
+  explicit ChunkedUploadStream(const ConsumedCallback& consumed_callback)
+      : net::UploadDataStream(true, 0),
+        consumed_callback_(consumed_callback),
+        chunk_offset_(0),
+        all_data_appended_(false),
+        keep_sent_chunks_(true),
+        sent_bytes_(0),
+        replayed_chunks_(0),
+        data_released_(false),
+        read_buffer_len_(0) {}
+
+  ~ChunkedUploadStream() override {}
+
+  void AppendChunk(scoped_refptr<const net::IOBufferWithSize> chunk,
+                   bool is_last) {
+    DCHECK(!all_data_appended_);
+    if (!chunk && !is_last)
+      return;
+
+    if (chunk)
+      chunks_.push_back(std::move(chunk));
+    all_data_appended_ = is_last;
+    if (!read_buffer_)
+      return;
+
+    int result = ReadChunks(read_buffer_.get(), read_buffer_len_);
+    if (result == net::ERR_IO_PENDING)
+      return;
+    read_buffer_ = nullptr;
+    read_buffer_len_ = 0;
+    OnReadCompleted(result);
+  }
+
+  // Stops keeping uploaded chunks, called when they can no longer be sent
+  // again.
+  void ReleaseSentChunks() {
+    keep_sent_chunks_ = false;
+    if (!sent_chunks_.empty())
+      data_released_ = true;
+    sent_chunks_.clear();
+    sent_bytes_ = 0;
+  }
+
+ private:
+  // net::UploadDataStream:
+  int InitInternal() override {
+    // Happens when the request is retried after data has been uploaded.
+    if (data_released_)
+      return net::ERR_UPLOAD_STREAM_REWIND_NOT_SUPPORTED;
+    // Send the uploaded chunks again, they have already been reported as
+    // consumed.
+    replayed_chunks_ += sent_chunks_.size();
+    chunks_.insert(chunks_.begin(), sent_chunks_.begin(), sent_chunks_.end());
+    sent_chunks_.clear();
+    sent_bytes_ = 0;
+    return net::OK;
+  }
+
+  int ReadInternal(net::IOBuffer* buf, int buf_len) override {
+    DCHECK_LT(0, buf_len);
+    DCHECK(!read_buffer_);
+    int result = ReadChunks(buf, buf_len);
+    if (result == net::ERR_IO_PENDING) {
+      read_buffer_ = buf;
+      read_buffer_len_ = buf_len;
+    }
+    return result;
+  }
+
+  void ResetInternal() override {
+    chunk_offset_ = 0;
+    read_buffer_ = nullptr;
+    read_buffer_len_ = 0;
+  }
+
+  int ReadChunks(net::IOBuffer* buf, int buf_len) {
+    int bytes_read = 0;
+    while (!chunks_.empty() && bytes_read < buf_len) {
+      const int chunk_size = chunks_.front()->size();
+      const int bytes =
+          std::min(buf_len - bytes_read, chunk_size - chunk_offset_);
+      memcpy(buf->data() + bytes_read, chunks_.front()->data() + chunk_offset_,
+             bytes);
+      bytes_read += bytes;
+      chunk_offset_ += bytes;
+      if (chunk_offset_ == chunk_size) {
+        OnChunkSent();
+        chunk_offset_ = 0;
+      }
+    }
+
+    if (chunks_.empty()) {
+      // Wait for more data, unless some has been read already.
+      if (!all_data_appended_)
+        return bytes_read > 0 ? bytes_read : net::ERR_IO_PENDING;
+      SetIsFinalChunk();
+    }
+    return bytes_read;
+  }
+
+  void OnChunkSent() {
+    scoped_refptr<const net::IOBufferWithSize> chunk = chunks_.front();
+    chunks_.pop_front();
+    if (replayed_chunks_ > 0)
+      --replayed_chunks_;
+    else
+      consumed_callback_.Run(chunk->size());
+
+    if (!keep_sent_chunks_) {
+      data_released_ = true;
+      return;
+    }
+    sent_bytes_ += chunk->size();
+    sent_chunks_.push_back(std::move(chunk));
+    if (sent_bytes_ > kMaxRetainedUploadSize)
+      ReleaseSentChunks();
+  }
+
+  const ConsumedCallback consumed_callback_;
+
+  std::deque<scoped_refptr<const net::IOBufferWithSize>> chunks_;
+  // Bytes of the first chunk that have been uploaded.
+  int chunk_offset_;
+  bool all_data_appended_;
+
+  // Uploaded chunks kept for rewinding.
+  bool keep_sent_chunks_;
+  std::deque<scoped_refptr<const net::IOBufferWithSize>> sent_chunks_;
+  int64_t sent_bytes_;
+  // Chunks at the front of |chunks_| that are sent again after a rewind.
+  size_t replayed_chunks_;
+  // Whether uploaded data has been dropped, so the stream can not rewind.
+  bool data_released_;
+
+  // The read waiting for more data to be appended.
+  scoped_refptr<net::IOBuffer> read_buffer_;
+  int read_buffer_len_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkedUploadStream);
+};
+
+// A buffer that is filled by several reads, its filled parts are handed to the
+// UI thread as ResponseBufferSlices.
+class ResponseBuffer : public net::IOBufferWithSize {
+ public:
+  explicit ResponseBuffer(int capacity)
+      : net::IOBufferWithSize(capacity),
+        capacity_(capacity),
+        filled_(0),
+        sent_(0) {}
+
+  int capacity() const { return capacity_; }
+  int filled() const { return filled_; }
+  int remaining() const { return capacity_ - filled_; }
+  // Bytes at the start that have already been handed out.
+  int sent() const { return sent_; }
+
+  void DidFill(int num_bytes) { filled_ += num_bytes; }
+  void DidSend() { sent_ = filled_; }
+
+ private:
+  ~ResponseBuffer() override {}
+
+  const int capacity_;
+  int filled_;
+  int sent_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponseBuffer);
+};
+
+// A part of a ResponseBuffer, which is kept alive by it. Reads write into the
+// unfilled part while the filled parts are used on the UI thread, which never
+// touch the same bytes.
+class ResponseBufferSlice : public net::IOBufferWithSize {
+ public:
+  ResponseBufferSlice(scoped_refptr<ResponseBuffer> buffer,
+                      int offset,
+                      int size)
+      : net::IOBufferWithSize(buffer->data() + offset, size),
+        buffer_(std::move(buffer)) {}
+
+ private:
+  ~ResponseBufferSlice() override {
+    // The memory belongs to |buffer_|.
+    data_ = nullptr;
+  }
+
+  scoped_refptr<ResponseBuffer> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponseBufferSlice);
+};
+
 }  // namespace internal
 
 AtomURLRequest::AtomURLRequest(api::URLRequest* delegate)
     : delegate_(delegate),
       is_chunked_upload_(false),
-      response_read_buffer_(new net::IOBuffer(kBufferSize)) {}
+      chunked_upload_stream_(nullptr),
+      response_buffer_capacity_(kMinBufferSize),
+      response_started_(false),
+      response_read_pending_(false),
+      response_read_paused_(false) {}
 
 AtomURLRequest::~AtomURLRequest() {
   DCHECK(!request_context_getter_);
@@ -118,6 +340,7 @@ void AtomURLRequest::DoInitialize(
 void AtomURLRequest::DoTerminate() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
   request_.reset();
+  chunked_upload_stream_ = nullptr;
   if (request_context_getter_) {
     request_context_getter_->RemoveObserver(this);
     request_context_getter_ = nullptr;
@@ -147,6 +370,20 @@ void AtomURLRequest::Cancel() {
                                    base::Bind(&AtomURLRequest::DoCancel, this));
 }
 
+void AtomURLRequest::PauseReading() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&AtomURLRequest::DoPauseReading, this));
+}
+
+void AtomURLRequest::ResumeReading() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&AtomURLRequest::DoResumeReading, this));
+}
+
 void AtomURLRequest::SetExtraHeader(const std::string& name,
                                     const std::string& value) const {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -189,21 +426,17 @@ void AtomURLRequest::DoWriteBuffer(
     // Chunked encoding case.
 
     bool first_call = false;
-    if (!chunked_stream_writer_) {
-      std::unique_ptr<net::ChunkedUploadDataStream> chunked_stream(
-          new net::ChunkedUploadDataStream(0));
-      chunked_stream_writer_ = chunked_stream->CreateWriter();
-      request_->set_upload(std::move(chunked_stream));
+    if (!chunked_upload_stream_) {
+      // The stream is owned by |request_|, which never outlives us.
+      chunked_upload_stream_ = new internal::ChunkedUploadStream(base::Bind(
+          &AtomURLRequest::OnUploadDataConsumed, base::Unretained(this)));
+      request_->set_upload(
+          std::unique_ptr<net::UploadDataStream>(chunked_upload_stream_));
       first_call = true;
     }
 
-    if (buffer)
-      // Non-empty buffer.
-      chunked_stream_writer_->AppendData(buffer->data(), buffer->size(),
-                                         is_last);
-    else if (is_last)
-      // Empty buffer and last chunk, i.e. request.end().
-      chunked_stream_writer_->AppendData(nullptr, 0, true);
+    // An empty buffer with |is_last| is request.end().
+    chunked_upload_stream_->AppendChunk(std::move(buffer), is_last);
 
     if (first_call) {
       request_->Start();
@@ -228,6 +461,14 @@ void AtomURLRequest::DoWriteBuffer(
   }
 }
 
+void AtomURLRequest::OnUploadDataConsumed(int num_bytes) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI, FROM_HERE,
+      base::Bind(&AtomURLRequest::InformDelegateUploadDataConsumed, this,
+                 num_bytes));
+}
+
 void AtomURLRequest::DoCancel() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
   if (request_) {
@@ -236,6 +477,22 @@ void AtomURLRequest::DoCancel() {
   DoTerminate();
 }
 
+void AtomURLRequest::DoPauseReading() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  // A read in progress still completes, the next one is not started.
+  response_read_paused_ = true;
+}
+
+void AtomURLRequest::DoResumeReading() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (!response_read_paused_)
+    return;
+
+  response_read_paused_ = false;
+  if (request_ && response_started_ && !response_read_pending_)
+    ReadResponse();
+}
+
 void AtomURLRequest::DoSetExtraHeader(const std::string& name,
                                       const std::string& value) const {
   DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
@@ -298,12 +555,17 @@ void AtomURLRequest::OnResponseStarted(net::URLRequest* request) {
   scoped_refptr<net::HttpResponseHeaders> response_headers =
       request->response_headers();
   const auto& status = request_->status();
+  // The upload can not be retried any more.
+  if (chunked_upload_stream_)
+    chunked_upload_stream_->ReleaseSentChunks();
+
   if (status.is_success()) {
     // Success or pending trigger a Read.
     content::BrowserThread::PostTask(
         content::BrowserThread::UI, FROM_HERE,
         base::Bind(&AtomURLRequest::InformDelegateResponseStarted, this,
                    response_headers));
+    response_started_ = true;
     ReadResponse();
   } else if (status.status() == net::URLRequestStatus::Status::FAILED) {
     // Report error on Start.
@@ -315,10 +577,29 @@ void AtomURLRequest::OnResponseStarted(net::URLRequest* request) {
 void AtomURLRequest::ReadResponse() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
 
+  if (response_read_paused_)
+    return;
+
   int bytes_read = -1;
-  if (request_->Read(response_read_buffer_.get(), kBufferSize, &bytes_read)) {
+  if (request_->Read(GetReadBuffer().get(), GetReadBufferSize(), &bytes_read))
     OnReadCompleted(request_.get(), bytes_read);
-  }
+  else
+    response_read_pending_ = request_->status().is_io_pending();
+}
+
+scoped_refptr<net::IOBuffer> AtomURLRequest::GetReadBuffer() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (!response_buffer_)
+    response_buffer_ = new internal::ResponseBuffer(response_buffer_capacity_);
+  // A pending read keeps the slice, and so the buffer, alive.
+  return new internal::ResponseBufferSlice(response_buffer_,
+                                           response_buffer_->filled(),
+                                           response_buffer_->remaining());
+}
+
+int AtomURLRequest::GetReadBufferSize() const {
+  return response_buffer_ ? response_buffer_->remaining()
+                          : response_buffer_capacity_;
 }
 
 void AtomURLRequest::OnReadCompleted(net::URLRequest* request, int bytes_read) {
@@ -327,13 +608,14 @@ void AtomURLRequest::OnReadCompleted(net::URLRequest* request, int bytes_read) {
     return;
   }
   DCHECK_EQ(request, request_.get());
+  response_read_pending_ = false;
 
-  const auto status = request_->status();
+  auto status = request_->status();
 
   bool response_error = false;
   bool data_ended = false;
   bool data_transfer_error = false;
-  do {
+  while (true) {
     if (!status.is_success()) {
       response_error = true;
       break;
@@ -342,12 +624,25 @@ void AtomURLRequest::OnReadCompleted(net::URLRequest* request, int bytes_read) {
       data_ended = true;
       break;
     }
-    if (bytes_read < 0 || !CopyAndPostBuffer(bytes_read)) {
+    if (bytes_read < 0 || !DidReadResponseData(bytes_read)) {
       data_transfer_error = true;
       break;
     }
-  } while (
-      request_->Read(response_read_buffer_.get(), kBufferSize, &bytes_read));
+    // Stop reading until the consumer asks for more data.
+    if (response_read_paused_)
+      break;
+    if (!request_->Read(GetReadBuffer().get(), GetReadBufferSize(),
+                        &bytes_read)) {
+      status = request_->status();
+      response_read_pending_ = status.is_io_pending();
+      response_error = !response_read_pending_;
+      break;
+    }
+  }
+  // Hand what has been read so far to the UI thread before waiting for more.
+  if (!response_error && !data_transfer_error &&
+      !FlushResponseBuffer(response_read_pending_))
+    data_transfer_error = true;
   if (response_error) {
     DoCancelWithError(net::ErrorToString(status.ToNetError()), false);
   } else if (data_ended) {
@@ -366,18 +661,52 @@ void AtomURLRequest::OnContextShuttingDown() {
   DoCancel();
 }
 
-bool AtomURLRequest::CopyAndPostBuffer(int bytes_read) {
+bool AtomURLRequest::DidReadResponseData(int bytes_read) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  DCHECK(response_buffer_);
 
-  // data is only a wrapper for the asynchronous response_read_buffer_.
-  // Make a deep copy of payload and transfer ownership to the UI thread.
-  auto buffer_copy = new net::IOBufferWithSize(bytes_read);
-  memcpy(buffer_copy->data(), response_read_buffer_->data(), bytes_read);
+  response_buffer_->DidFill(bytes_read);
+  if (response_buffer_->remaining() > 0)
+    return true;
+
+  // Data arrives faster than the buffer can hold, use a larger one next.
+  response_buffer_capacity_ =
+      std::min(response_buffer_capacity_ * 2, kMaxBufferSize);
+  return FlushResponseBuffer(false);
+}
+
+bool AtomURLRequest::FlushResponseBuffer(bool read_pending) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (!response_buffer_)
+    return true;
+  int unsent = response_buffer_->filled() - response_buffer_->sent();
+  if (unsent == 0)
+    return true;
+
+  // Large data is handed out without copying, a pending read only writes
+  // after it.
+  scoped_refptr<net::IOBufferWithSize> data;
+  if (unsent < response_buffer_->capacity() / kMinSliceFraction) {
+    data = new net::IOBufferWithSize(unsent);
+    memcpy(data->data(), response_buffer_->data() + response_buffer_->sent(),
+           unsent);
+  } else {
+    data = new internal::ResponseBufferSlice(
+        response_buffer_, response_buffer_->sent(), unsent);
+  }
+  response_buffer_->DidSend();
+  if (response_buffer_->remaining() == 0)
+    response_buffer_ = nullptr;
+
+  // Data arrives slowly, use a smaller buffer next.
+  if (read_pending && unsent < response_buffer_capacity_ / 4) {
+    response_buffer_capacity_ =
+        std::max(response_buffer_capacity_ / 2, kMinBufferSize);
+  }
 
   return content::BrowserThread::PostTask(
       content::BrowserThread::UI, FROM_HERE,
-      base::Bind(&AtomURLRequest::InformDelegateResponseData, this,
-                 buffer_copy));
+      base::Bind(&AtomURLRequest::InformDelegateResponseData, this, data));
 }
 
 void AtomURLRequest::InformDelegateAuthenticationRequired(
@@ -404,6 +733,13 @@ void AtomURLRequest::InformDelegateResponseData(
     delegate_->OnResponseData(data);
 }
 
+void AtomURLRequest::InformDelegateUploadDataConsumed(int num_bytes) const {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (delegate_)
+    delegate_->OnUploadDataConsumed(num_bytes);
+}
+
 void AtomURLRequest::InformDelegateResponseCompleted() const {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
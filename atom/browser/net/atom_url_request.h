@@ -13,7 +13,6 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/auth.h"
-#include "net/base/chunked_upload_data_stream.h"
 #include "net/base/io_buffer.h"
 #include "net/base/upload_element_reader.h"
 #include "net/http/http_response_headers.h"
@@ -22,6 +21,11 @@
 
 namespace atom {
 
+namespace internal {
+class ChunkedUploadStream;
+class ResponseBuffer;
+}
+
 class AtomURLRequest : public base::RefCountedThreadSafe<AtomURLRequest>,
                        public net::URLRequest::Delegate,
                        public net::URLRequestContextGetterObserver {
@@ -36,6 +40,10 @@ class AtomURLRequest : public base::RefCountedThreadSafe<AtomURLRequest>,
   bool Write(scoped_refptr<const net::IOBufferWithSize> buffer, bool is_last);
   void SetChunkedUpload(bool is_chunked_upload);
   void Cancel();
+  // Stops and restarts reading the response, the data already read is still
+  // delivered after pausing.
+  void PauseReading();
+  void ResumeReading();
   void SetExtraHeader(const std::string& name, const std::string& value) const;
   void RemoveExtraHeader(const std::string& name) const;
   void PassLoginInformation(const base::string16& username,
@@ -63,7 +71,11 @@ class AtomURLRequest : public base::RefCountedThreadSafe<AtomURLRequest>,
   void DoTerminate();
   void DoWriteBuffer(scoped_refptr<const net::IOBufferWithSize> buffer,
                      bool is_last);
+  // Called when a chunked upload has sent a buffer passed to Write.
+  void OnUploadDataConsumed(int num_bytes);
   void DoCancel();
+  void DoPauseReading();
+  void DoResumeReading();
   void DoSetExtraHeader(const std::string& name,
                         const std::string& value) const;
   void DoRemoveExtraHeader(const std::string& name) const;
@@ -73,7 +85,14 @@ class AtomURLRequest : public base::RefCountedThreadSafe<AtomURLRequest>,
   void DoCancelWithError(const std::string& error, bool isRequestError);
 
   void ReadResponse();
-  bool CopyAndPostBuffer(int bytes_read);
+  // Returns where the next read writes to.
+  scoped_refptr<net::IOBuffer> GetReadBuffer();
+  int GetReadBufferSize() const;
+  // Called after |bytes_read| bytes have been read into the read buffer.
+  bool DidReadResponseData(int bytes_read);
+  // Posts the data read so far to the UI thread, |read_pending| tells whether
+  // a read into the buffer is still in progress.
+  bool FlushResponseBuffer(bool read_pending);
 
   void InformDelegateAuthenticationRequired(
       scoped_refptr<net::AuthChallengeInfo> auth_info) const;
@@ -81,6 +100,7 @@ class AtomURLRequest : public base::RefCountedThreadSafe<AtomURLRequest>,
       scoped_refptr<net::HttpResponseHeaders>) const;
   void InformDelegateResponseData(
       scoped_refptr<net::IOBufferWithSize> data) const;
+  void InformDelegateUploadDataConsumed(int num_bytes) const;
   void InformDelegateResponseCompleted() const;
   void InformDelegateErrorOccured(const std::string& error,
                                   bool isRequestError) const;
@@ -90,11 +110,21 @@ class AtomURLRequest : public base::RefCountedThreadSafe<AtomURLRequest>,
   scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
 
   bool is_chunked_upload_;
-  std::unique_ptr<net::ChunkedUploadDataStream> chunked_stream_;
-  std::unique_ptr<net::ChunkedUploadDataStream::Writer> chunked_stream_writer_;
+  // Owned by |request_|.
+  internal::ChunkedUploadStream* chunked_upload_stream_;
   std::vector<std::unique_ptr<net::UploadElementReader>>
       upload_element_readers_;
-  scoped_refptr<net::IOBuffer> response_read_buffer_;
+
+  // Consecutive reads are collected in one buffer, whose new data is posted to
+  // the UI thread when it is full or when there is no more data to read for
+  // now.
+  scoped_refptr<internal::ResponseBuffer> response_buffer_;
+  int response_buffer_capacity_;
+
+  // Reading state of the response, only used on the IO thread.
+  bool response_started_;
+  bool response_read_pending_;
+  bool response_read_paused_;
 
   DISALLOW_COPY_AND_ASSIGN(AtomURLRequest);
 };
@@ -0,0 +1,83 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/cookie_index.h"
+
+#include <tuple>
+#include <utility>
+
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+
+namespace atom {
+
+namespace {
+
+std::string StripLeadingDot(const std::string& domain) {
+  if (!domain.empty() && domain[0] == '.')
+    return domain.substr(1);
+  return domain;
+}
+
+}  // namespace
+
+bool CookieIndex::Key::operator<(const Key& other) const {
+  return std::tie(site, domain, path, name) <
+         std::tie(other.site, other.domain, other.path, other.name);
+}
+
+CookieIndex::CookieIndex() : loaded_(false) {
+}
+
+CookieIndex::~CookieIndex() {
+}
+
+// static
+CookieIndex::Key CookieIndex::KeyFor(const net::CanonicalCookie& cookie) {
+  std::string site = GetSite(cookie.Domain());
+  // Cookies of hosts without a registrable domain are their own site.
+  if (site.empty())
+    site = StripLeadingDot(cookie.Domain());
+  return { site, cookie.Domain(), cookie.Path(), cookie.Name() };
+}
+
+// static
+std::string CookieIndex::GetSite(const std::string& domain) {
+  return net::registry_controlled_domains::GetDomainAndRegistry(
+      StripLeadingDot(domain),
+      net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+}
+
+void CookieIndex::Load(const net::CookieList& cookies) {
+  cookies_.clear();
+  for (const auto& cookie : cookies)
+    cookies_.insert(std::make_pair(KeyFor(cookie), cookie));
+  loaded_ = true;
+}
+
+void CookieIndex::OnCookieChanged(const net::CanonicalCookie& cookie,
+                                  bool removed) {
+  Key key = KeyFor(cookie);
+  if (removed) {
+    cookies_.erase(key);
+  } else {
+    cookies_.erase(key);
+    cookies_.insert(std::make_pair(std::move(key), cookie));
+  }
+}
+
+bool CookieIndex::GetSiteRange(const std::string& domain,
+                               Map::const_iterator* begin,
+                               Map::const_iterator* end) const {
+  std::string site = GetSite(domain);
+  if (site.empty())
+    return false;
+
+  *begin = cookies_.lower_bound({ site, "", "", "" });
+  // The smallest site sorting after |site|.
+  site.push_back('\0');
+  *end = cookies_.lower_bound({ site, "", "", "" });
+  return true;
+}
+
+}  // namespace atom
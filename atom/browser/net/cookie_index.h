@@ -0,0 +1,67 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_COOKIE_INDEX_H_
+#define ATOM_BROWSER_NET_COOKIE_INDEX_H_
+
+#include <map>
+#include <string>
+
+#include "base/macros.h"
+#include "net/cookies/canonical_cookie.h"
+
+namespace atom {
+
+// An ordered copy of the cookies of a cookie store, in which the cookies of a
+// site can be found without enumerating the whole store.
+//
+// It is filled from the store once and then kept up to date with the changes
+// reported to the cookie monster delegate. It must only be used on the IO
+// thread.
+class CookieIndex {
+ public:
+  // Orders cookies by their registrable domain first, so the cookies of a
+  // site and its subdomains are next to each other.
+  struct Key {
+    bool operator<(const Key& other) const;
+
+    std::string site;
+    std::string domain;
+    std::string path;
+    std::string name;
+  };
+
+  using Map = std::map<Key, net::CanonicalCookie>;
+
+  CookieIndex();
+  ~CookieIndex();
+
+  static Key KeyFor(const net::CanonicalCookie& cookie);
+
+  // Returns the registrable domain of |domain|, or an empty string when it
+  // has none, e.g. for public suffixes and IP addresses.
+  static std::string GetSite(const std::string& domain);
+
+  bool is_loaded() const { return loaded_; }
+  void Load(const net::CookieList& cookies);
+  void OnCookieChanged(const net::CanonicalCookie& cookie, bool removed);
+
+  // Returns the cookies of the site of |domain| in [begin, end), or false when
+  // the domain can include cookies of several sites.
+  bool GetSiteRange(const std::string& domain,
+                    Map::const_iterator* begin,
+                    Map::const_iterator* end) const;
+
+  const Map& cookies() const { return cookies_; }
+
+ private:
+  bool loaded_;
+  Map cookies_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieIndex);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_COOKIE_INDEX_H_
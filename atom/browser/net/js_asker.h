@@ -5,6 +5,10 @@
 #ifndef ATOM_BROWSER_NET_JS_ASKER_H_
 #define ATOM_BROWSER_NET_JS_ASKER_H_
 
+#include <memory>
+#include <utility>
+
+#include "atom/browser/net/protocol_response_cache.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
@@ -33,6 +37,7 @@ using ResponseCallback =
 void AskForOptions(v8::Isolate* isolate,
                    const JavaScriptHandler& handler,
                    std::unique_ptr<base::DictionaryValue> request_details,
+                   bool convert_options,
                    const BeforeStartCallback& before_start,
                    const ResponseCallback& callback);
 
@@ -45,42 +50,71 @@ template<typename RequestJob>
 class JsAsker : public RequestJob {
  public:
   JsAsker(net::URLRequest* request, net::NetworkDelegate* network_delegate)
-      : RequestJob(request, network_delegate), weak_factory_(this) {}
+      : RequestJob(request, network_delegate),
+        isolate_(nullptr),
+        request_context_getter_(nullptr),
+        weak_factory_(this) {}
 
   // Called by |CustomProtocolHandler| to store handler related information.
   void SetHandlerInfo(
       v8::Isolate* isolate,
       net::URLRequestContextGetter* request_context_getter,
-      const JavaScriptHandler& handler) {
+      const JavaScriptHandler& handler,
+      ProtocolResponseCache* response_cache) {
     isolate_ = isolate;
     request_context_getter_ = request_context_getter;
     handler_ = handler;
+    response_cache_ = response_cache;
   }
 
   // Subclass should do initailze work here.
   virtual void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) {}
+  // Subclass that reads everything it needs in BeforeStartInUI can skip the
+  // conversion of the options, StartAsync then gets an empty dictionary.
+  virtual bool ShouldConvertOptions() const { return true; }
   virtual void StartAsync(std::unique_ptr<base::Value> options) = 0;
 
   net::URLRequestContextGetter* request_context_getter() const {
     return request_context_getter_;
   }
 
- private:
-  // RequestJob:
-  void Start() override {
-    std::unique_ptr<base::DictionaryValue> request_details(
-        new base::DictionaryValue);
-    FillRequestDetails(request_details.get(), RequestJob::request());
+  // Subclass can store its response here when the handler allows it.
+  ProtocolResponseCache* response_cache() const {
+    return response_cache_.get();
+  }
+
+ protected:
+  void set_response_cache(ProtocolResponseCache* response_cache) {
+    response_cache_ = response_cache;
+  }
+
+  // Asks the JavaScript handler for the options of the request, |callback|
+  // is called with them on the IO thread. Subclass can get the options from
+  // somewhere else.
+  virtual void AskForOptions(
+      std::unique_ptr<base::DictionaryValue> request_details,
+      const internal::ResponseCallback& callback) {
     content::BrowserThread::PostTask(
         content::BrowserThread::UI, FROM_HERE,
         base::Bind(&internal::AskForOptions,
                    isolate_,
                    handler_,
                    base::Passed(&request_details),
+                   ShouldConvertOptions(),
                    base::Bind(&JsAsker::BeforeStartInUI,
                               weak_factory_.GetWeakPtr()),
-                   base::Bind(&JsAsker::OnResponse,
-                              weak_factory_.GetWeakPtr())));
+                   callback));
+  }
+
+ private:
+  // RequestJob:
+  void Start() override {
+    std::unique_ptr<base::DictionaryValue> request_details(
+        new base::DictionaryValue);
+    FillRequestDetails(request_details.get(), RequestJob::request());
+    AskForOptions(std::move(request_details),
+                  base::Bind(&JsAsker::OnResponse,
+                             weak_factory_.GetWeakPtr()));
   }
   void GetResponseInfo(net::HttpResponseInfo* info) override {
     info->headers = new net::HttpResponseHeaders("");
@@ -101,6 +135,7 @@ class JsAsker : public RequestJob {
   v8::Isolate* isolate_;
   net::URLRequestContextGetter* request_context_getter_;
   JavaScriptHandler handler_;
+  scoped_refptr<ProtocolResponseCache> response_cache_;
 
   base::WeakPtrFactory<JsAsker> weak_factory_;
 
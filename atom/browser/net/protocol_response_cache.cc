@@ -0,0 +1,93 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_response_cache.h"
+
+#include "base/values.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+// Limits of the responses kept for one protocol handler.
+const size_t kMaxEntries = 1000;
+const size_t kMaxTotalBytes = 64 * 1024 * 1024;
+
+}  // namespace
+
+ProtocolResponseCache::Entry::Entry() {
+}
+
+ProtocolResponseCache::Entry::Entry(const Entry& other) = default;
+
+ProtocolResponseCache::Entry::~Entry() {
+}
+
+ProtocolResponseCache::ProtocolResponseCache()
+    : entries_(kMaxEntries), total_bytes_(0) {
+}
+
+ProtocolResponseCache::~ProtocolResponseCache() {
+}
+
+const ProtocolResponseCache::Entry* ProtocolResponseCache::Get(
+    const GURL& url) {
+  auto it = entries_.Get(url);
+  if (it == entries_.end())
+    return nullptr;
+
+  if (it->second.expiration_time <= base::TimeTicks::Now()) {
+    total_bytes_ -= it->second.data->size();
+    entries_.Erase(it);
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+void ProtocolResponseCache::MaybePut(
+    const net::URLRequest* request,
+    const base::DictionaryValue& options,
+    const std::string& mime_type,
+    const std::string& charset,
+    scoped_refptr<base::RefCountedMemory> data) {
+  const base::DictionaryValue* cache = nullptr;
+  int max_age = 0;
+  if (!options.GetDictionary("cache", &cache) ||
+      !cache->GetInteger("maxAge", &max_age) || max_age <= 0)
+    return;
+
+  // Only plain GET requests get the same response every time.
+  if (request->method() != "GET" || !data || data->size() > kMaxTotalBytes)
+    return;
+
+  auto existing = entries_.Peek(request->url());
+  if (existing != entries_.end()) {
+    total_bytes_ -= existing->second.data->size();
+    entries_.Erase(existing);
+  }
+
+  Entry entry;
+  entry.mime_type = mime_type;
+  entry.charset = charset;
+  cache->GetString("etag", &entry.etag);
+  entry.data = data;
+  entry.expiration_time =
+      base::TimeTicks::Now() + base::TimeDelta::FromSeconds(max_age);
+
+  // Evict the least recently used responses until the new one fits, the
+  // eviction of MRUCache itself would not update |total_bytes_|.
+  total_bytes_ += data->size();
+  while (!entries_.empty() &&
+         (total_bytes_ > kMaxTotalBytes || entries_.size() >= kMaxEntries)) {
+    auto oldest = entries_.rbegin();
+    total_bytes_ -= oldest->second.data->size();
+    entries_.Erase(oldest);
+  }
+
+  entries_.Put(request->url(), entry);
+}
+
+}  // namespace atom
@@ -0,0 +1,70 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+#include "url/gurl.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Keeps the responses of a custom protocol handler on the IO thread, so
+// requests for them can be served without asking the JavaScript handler.
+//
+// A response is only kept when the handler passed a |cache| option with a
+// positive |maxAge| in seconds, and is dropped once it gets older than that.
+class ProtocolResponseCache : public base::RefCounted<ProtocolResponseCache> {
+ public:
+  struct Entry {
+    Entry();
+    Entry(const Entry& other);
+    ~Entry();
+
+    std::string mime_type;
+    std::string charset;
+    std::string etag;
+    scoped_refptr<base::RefCountedMemory> data;
+    base::TimeTicks expiration_time;
+  };
+
+  ProtocolResponseCache();
+
+  // Returns the fresh response of |url|, or nullptr if there is none.
+  const Entry* Get(const GURL& url);
+
+  // Stores the response of |request| if |options| asks for it.
+  void MaybePut(const net::URLRequest* request,
+                const base::DictionaryValue& options,
+                const std::string& mime_type,
+                const std::string& charset,
+                scoped_refptr<base::RefCountedMemory> data);
+
+ private:
+  friend class base::RefCounted<ProtocolResponseCache>;
+
+  ~ProtocolResponseCache();
+
+  base::MRUCache<GURL, Entry> entries_;
+  size_t total_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolResponseCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
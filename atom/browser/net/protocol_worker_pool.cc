@@ -0,0 +1,374 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_worker_pool.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/native_mate_converters/v8_value_converter.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
+#include "base/threading/thread.h"
+#include "base/values.h"
+#include "gin/public/isolate_holder.h"
+#include "native_mate/dictionary.h"
+#include "net/base/net_errors.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+const int kMaxDefaultWorkers = 4;
+
+// A minimal Buffer for the worker scripts, on top of Uint8Array. It also makes
+// fs.readFileSync return Buffers.
+const char kBufferScript[] = R"(
+(function (global) {
+  'use strict'
+
+  const encodeUtf8 = (string) => unescape(encodeURIComponent(string))
+  const decodeUtf8 = (binary) => decodeURIComponent(escape(binary))
+
+  const toBinary = (bytes) => {
+    let binary = ''
+    for (let i = 0; i < bytes.length; i += 8192) {
+      binary += String.fromCharCode.apply(null, bytes.subarray(i, i + 8192))
+    }
+    return binary
+  }
+
+  class Buffer extends Uint8Array {
+    static from (value, encodingOrOffset, length) {
+      if (typeof value === 'string') {
+        const encoding = (encodingOrOffset || 'utf8').toLowerCase()
+        let binary
+        if (encoding === 'utf8' || encoding === 'utf-8') {
+          binary = encodeUtf8(value)
+        } else if (encoding === 'latin1' || encoding === 'binary') {
+          binary = value
+        } else if (encoding === 'hex') {
+          const buffer = new Buffer(value.length >> 1)
+          for (let i = 0; i < buffer.length; ++i) {
+            buffer[i] = parseInt(value.substr(i * 2, 2), 16)
+          }
+          return buffer
+        } else {
+          throw new TypeError('Unknown encoding: ' + encoding)
+        }
+        const buffer = new Buffer(binary.length)
+        for (let i = 0; i < binary.length; ++i) {
+          buffer[i] = binary.charCodeAt(i)
+        }
+        return buffer
+      }
+      if (value instanceof ArrayBuffer) {
+        const offset = encodingOrOffset || 0
+        return new Buffer(value, offset,
+                          length === undefined ? value.byteLength - offset
+                                               : length)
+      }
+      const buffer = new Buffer(value.length)
+      buffer.set(value)
+      return buffer
+    }
+
+    static alloc (size) {
+      return new Buffer(size)
+    }
+
+    static isBuffer (value) {
+      return value instanceof Buffer
+    }
+
+    static byteLength (value) {
+      return typeof value === 'string' ? encodeUtf8(value).length
+                                       : value.byteLength
+    }
+
+    static concat (list, totalLength) {
+      if (totalLength === undefined) {
+        totalLength = list.reduce((sum, item) => sum + item.length, 0)
+      }
+      const buffer = new Buffer(totalLength)
+      let offset = 0
+      for (const item of list) {
+        if (offset + item.length > totalLength) {
+          buffer.set(item.subarray(0, totalLength - offset), offset)
+          break
+        }
+        buffer.set(item, offset)
+        offset += item.length
+      }
+      return buffer
+    }
+
+    // Like Node's Buffer, slices share the memory.
+    slice (start, end) {
+      const view = this.subarray(start, end)
+      return new Buffer(view.buffer, view.byteOffset, view.length)
+    }
+
+    toString (encoding, start, end) {
+      encoding = (encoding || 'utf8').toLowerCase()
+      const binary = toBinary(this.subarray(start, end))
+      if (encoding === 'utf8' || encoding === 'utf-8') return decodeUtf8(binary)
+      if (encoding === 'latin1' || encoding === 'binary') return binary
+      if (encoding === 'hex') {
+        let hex = ''
+        for (let i = 0; i < binary.length; ++i) {
+          hex += (0x100 + binary.charCodeAt(i)).toString(16).substr(1)
+        }
+        return hex
+      }
+      throw new TypeError('Unknown encoding: ' + encoding)
+    }
+  }
+
+  const readFileSync = global.fs.readFileSync
+  global.fs.readFileSync = function (path, options) {
+    const bytes = readFileSync(path)
+    const buffer = new Buffer(bytes.buffer, bytes.byteOffset, bytes.length)
+    const encoding = typeof options === 'string' ? options
+                                                 : options && options.encoding
+    return encoding ? buffer.toString(encoding) : buffer
+  }
+
+  global.Buffer = Buffer
+})(this)
+)";
+
+// fs.readFileSync(path), returns the content as a Uint8Array. Encodings are
+// handled by the wrapper in kBufferScript.
+v8::Local<v8::Value> ReadFileSync(mate::Arguments* args) {
+  base::FilePath path;
+  if (!args->GetNext(&path)) {
+    args->ThrowError("Path must be a string");
+    return v8::Undefined(args->isolate());
+  }
+
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  int64_t length = file.GetLength();
+  if (!file.IsValid() || length < 0 ||
+      length > std::numeric_limits<int>::max()) {
+    args->ThrowError("Failed to read " + path.AsUTF8Unsafe());
+    return v8::Undefined(args->isolate());
+  }
+
+  // Read straight into the memory of the ArrayBuffer.
+  v8::Local<v8::ArrayBuffer> buffer =
+      v8::ArrayBuffer::New(args->isolate(), static_cast<size_t>(length));
+  char* data = static_cast<char*>(buffer->GetContents().Data());
+  int size = static_cast<int>(length);
+  int bytes_read = 0;
+  while (bytes_read < size) {
+    int result = file.ReadAtCurrentPos(data + bytes_read, size - bytes_read);
+    if (result < 0) {
+      args->ThrowError("Failed to read " + path.AsUTF8Unsafe());
+      return v8::Undefined(args->isolate());
+    }
+    if (result == 0)
+      break;
+    bytes_read += result;
+  }
+  return v8::Uint8Array::New(buffer, 0, bytes_read);
+}
+
+// fs.existsSync(path).
+bool ExistsSync(const base::FilePath& path) {
+  return base::PathExists(path);
+}
+
+// The request job only takes binary data, so strings returned by the handler
+// are converted here.
+void NormalizeResponse(std::unique_ptr<base::Value>* response) {
+  std::string data;
+  base::DictionaryValue* dict = nullptr;
+  if ((*response)->GetAsString(&data)) {
+    *response = std::unique_ptr<base::Value>(
+        base::BinaryValue::CreateWithCopiedBuffer(data.data(), data.size()));
+  } else if ((*response)->GetAsDictionary(&dict) &&
+             dict->GetString("data", &data)) {
+    dict->Set("data", std::unique_ptr<base::Value>(
+        base::BinaryValue::CreateWithCopiedBuffer(data.data(), data.size())));
+  }
+}
+
+}  // namespace
+
+// A thread with its own isolate that runs the handler script.
+class ProtocolWorker : public base::Thread {
+ public:
+  ProtocolWorker(const base::FilePath& script_path, int index)
+      : base::Thread(base::StringPrintf("ProtocolWorker%d", index)),
+        script_path_(script_path) {
+  }
+
+  ~ProtocolWorker() override {
+    Stop();
+  }
+
+  void HandleRequest(std::unique_ptr<base::DictionaryValue> request_details,
+                     const ProtocolWorkerPool::ResponseCallback& callback) {
+    std::unique_ptr<base::Value> response = RunHandler(*request_details);
+    bool success = !!response;
+    if (success)
+      NormalizeResponse(&response);
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(callback, success, base::Passed(&response)));
+  }
+
+ protected:
+  // base::Thread:
+  void Init() override {
+    isolate_holder_.reset(new gin::IsolateHolder);
+    v8::Isolate* isolate = isolate_holder_->isolate();
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    context_.Reset(isolate, context);
+
+    mate::Dictionary fs = mate::Dictionary::CreateEmpty(isolate);
+    fs.SetMethod("readFileSync", &ReadFileSync);
+    fs.SetMethod("existsSync", &ExistsSync);
+    mate::Dictionary global(isolate, context->Global());
+    global.Set("fs", fs);
+    if (!RunScript(context, "buffer.js", kBufferScript))
+      return;
+
+    std::string source;
+    if (!base::ReadFileToString(script_path_, &source)) {
+      LOG(ERROR) << "Failed to read protocol worker script "
+                 << script_path_.AsUTF8Unsafe();
+      return;
+    }
+
+    if (!RunScript(context, script_path_.AsUTF8Unsafe(), source))
+      return;
+
+    v8::Local<v8::Function> handler;
+    if (global.Get("handleRequest", &handler))
+      handler_.Reset(isolate, handler);
+    else
+      LOG(ERROR) << "Protocol worker script has no handleRequest function";
+  }
+
+  void CleanUp() override {
+    handler_.Reset();
+    context_.Reset();
+    isolate_holder_.reset();
+  }
+
+ private:
+  // Runs |source| in |context|, logs the exception when it throws.
+  static bool RunScript(v8::Local<v8::Context> context,
+                        const std::string& name,
+                        const std::string& source) {
+    v8::Isolate* isolate = context->GetIsolate();
+    v8::TryCatch try_catch(isolate);
+    v8::ScriptOrigin origin(mate::StringToV8(isolate, name));
+    v8::Local<v8::Script> script;
+    if (!v8::Script::Compile(context, mate::StringToV8(isolate, source),
+                             &origin).ToLocal(&script) ||
+        script->Run(context).IsEmpty()) {
+      LOG(ERROR) << "Failed to run protocol worker script " << name << ": "
+                 << *v8::String::Utf8Value(try_catch.Exception());
+      return false;
+    }
+    return true;
+  }
+
+  // Calls handleRequest, returns null when it failed.
+  std::unique_ptr<base::Value> RunHandler(
+      const base::DictionaryValue& request_details) {
+    if (handler_.IsEmpty())
+      return nullptr;
+
+    v8::Isolate* isolate = isolate_holder_->isolate();
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Local<v8::Context>::New(isolate,
+                                                                 context_);
+    v8::Context::Scope context_scope(context);
+    v8::TryCatch try_catch(isolate);
+
+    V8ValueConverter converter;
+    v8::Local<v8::Value> details =
+        converter.ToV8Value(&request_details, context);
+    v8::Local<v8::Function> handler =
+        v8::Local<v8::Function>::New(isolate, handler_);
+    v8::Local<v8::Value> result;
+    if (!handler->Call(context, context->Global(), 1, &details)
+             .ToLocal(&result)) {
+      LOG(ERROR) << "Protocol worker handler failed: "
+                 << *v8::String::Utf8Value(try_catch.Exception());
+      return nullptr;
+    }
+
+    return std::unique_ptr<base::Value>(
+        converter.FromV8Value(result, context));
+  }
+
+  const base::FilePath script_path_;
+
+  // Only used on the worker thread.
+  std::unique_ptr<gin::IsolateHolder> isolate_holder_;
+  v8::Global<v8::Context> context_;
+  v8::Global<v8::Function> handler_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolWorker);
+};
+
+// static
+int ProtocolWorkerPool::GetDefaultWorkerCount() {
+  return std::max(1, std::min(kMaxDefaultWorkers,
+                              base::SysInfo::NumberOfProcessors() - 1));
+}
+
+ProtocolWorkerPool::ProtocolWorkerPool(const base::FilePath& script_path,
+                                       int worker_count)
+    : next_worker_(0) {
+  for (int i = 0; i < worker_count; ++i) {
+    std::unique_ptr<ProtocolWorker> worker(new ProtocolWorker(script_path, i));
+    if (worker->Start())
+      workers_.push_back(std::move(worker));
+  }
+}
+
+ProtocolWorkerPool::~ProtocolWorkerPool() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+}
+
+void ProtocolWorkerPool::HandleRequest(
+    std::unique_ptr<base::DictionaryValue> request_details,
+    const ResponseCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (workers_.empty()) {
+    callback.Run(false, nullptr);
+    return;
+  }
+
+  // The upload data holds binary values, which can only be converted to V8
+  // with Node's Buffer.
+  request_details->Remove("uploadData", nullptr);
+
+  ProtocolWorker* worker = workers_[next_worker_++ % workers_.size()].get();
+  // The pool stops its workers before they are destroyed, which runs the
+  // pending requests first.
+  worker->task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&ProtocolWorker::HandleRequest, base::Unretained(worker),
+                 base::Passed(&request_details), callback));
+}
+
+}  // namespace atom
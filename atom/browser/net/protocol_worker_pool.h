@@ -0,0 +1,66 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_WORKER_POOL_H_
+#define ATOM_BROWSER_NET_PROTOCOL_WORKER_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace base {
+class DictionaryValue;
+class Value;
+}
+
+namespace atom {
+
+class ProtocolWorker;
+
+// Runs the protocol handler script of registerWorkerProtocol in a few worker
+// threads, each with its own V8 isolate, so requests are answered without
+// going through the UI thread.
+//
+// The script only gets a small API: it must define a global handleRequest
+// function, and can read files with the global fs object.
+class ProtocolWorkerPool
+    : public base::RefCountedThreadSafe<
+          ProtocolWorkerPool,
+          content::BrowserThread::DeleteOnFileThread> {
+ public:
+  using ResponseCallback =
+      base::Callback<void(bool, std::unique_ptr<base::Value> options)>;
+
+  // Returns the number of workers used when the app does not choose one.
+  static int GetDefaultWorkerCount();
+
+  ProtocolWorkerPool(const base::FilePath& script_path, int worker_count);
+
+  // Passes the request to the next worker, |callback| is called on the IO
+  // thread with the options returned by handleRequest.
+  void HandleRequest(std::unique_ptr<base::DictionaryValue> request_details,
+                     const ResponseCallback& callback);
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::FILE>;
+  friend class base::DeleteHelper<ProtocolWorkerPool>;
+
+  // Stopping the workers joins their threads, so it is done on FILE thread.
+  ~ProtocolWorkerPool();
+
+  std::vector<std::unique_ptr<ProtocolWorker>> workers_;
+  // Only used on the IO thread.
+  size_t next_worker_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolWorkerPool);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_WORKER_POOL_H_
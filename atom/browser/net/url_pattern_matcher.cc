@@ -0,0 +1,113 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_pattern_matcher.h"
+
+#include "base/macros.h"
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+// Schemes that get their own bit in the scheme bit set, URLs with any other
+// scheme are tested against all candidate patterns.
+const char* const kKnownSchemes[] = {
+  "http", "https", "ws", "wss", "ftp", "file", "data", "blob",
+  "chrome", "chrome-extension", "chrome-devtools", "about",
+};
+const size_t kKnownSchemeCount = arraysize(kKnownSchemes);
+const uint32_t kOtherScheme = 1u << kKnownSchemeCount;
+
+uint32_t SchemeToBit(const std::string& scheme) {
+  for (size_t i = 0; i < kKnownSchemeCount; ++i) {
+    if (scheme == kKnownSchemes[i])
+      return 1u << i;
+  }
+  return kOtherScheme;
+}
+
+}  // namespace
+
+URLPatternMatcher::URLPatternMatcher() {
+}
+
+URLPatternMatcher::URLPatternMatcher(const URLPatterns& patterns) {
+  entries_.reserve(patterns.size());
+  for (const auto& pattern : patterns) {
+    Entry entry = { pattern, kOtherScheme };
+    for (size_t i = 0; i < kKnownSchemeCount; ++i) {
+      if (pattern.match_all_urls() || pattern.MatchesScheme(kKnownSchemes[i]))
+        entry.schemes |= 1u << i;
+    }
+
+    size_t index = entries_.size();
+    entries_.push_back(entry);
+
+    // File URLs are matched without looking at the host, so patterns without
+    // a host have to be tried for every URL.
+    const std::string host = base::ToLowerASCII(pattern.host());
+    if (pattern.match_all_urls() || host.empty())
+      any_host_.push_back(index);
+    else if (pattern.match_subdomains())
+      domains_[host].push_back(index);
+    else
+      hosts_[host].push_back(index);
+  }
+}
+
+URLPatternMatcher::~URLPatternMatcher() {
+}
+
+bool URLPatternMatcher::MatchesURL(const GURL& url) const {
+  // The patterns match the inner URL of filesystem URLs, which the index does
+  // not know about.
+  if (url.SchemeIsFileSystem()) {
+    for (const auto& entry : entries_) {
+      if (entry.pattern.MatchesURL(url))
+        return true;
+    }
+    return false;
+  }
+
+  const uint32_t scheme = SchemeToBit(url.scheme());
+  if (MatchesAny(any_host_, url, scheme))
+    return true;
+
+  const std::string& host = url.host();
+  auto it = hosts_.find(host);
+  if (it != hosts_.end() && MatchesAny(it->second, url, scheme))
+    return true;
+
+  if (domains_.empty())
+    return false;
+
+  // Try the host itself and each of its parent domains.
+  size_t start = 0;
+  while (start != std::string::npos && start < host.size()) {
+    it = domains_.find(host.substr(start));
+    if (it != domains_.end() && MatchesAny(it->second, url, scheme))
+      return true;
+    start = host.find('.', start);
+    if (start != std::string::npos)
+      ++start;
+  }
+  return false;
+}
+
+bool URLPatternMatcher::MatchesAny(const std::vector<size_t>& candidates,
+                                   const GURL& url,
+                                   uint32_t scheme) const {
+  for (size_t index : candidates) {
+    const Entry& entry = entries_[index];
+    if (!(entry.schemes & scheme))
+      continue;
+    if (entry.pattern.MatchesURL(url))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace atom
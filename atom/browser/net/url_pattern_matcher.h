@@ -0,0 +1,62 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+#define ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace atom {
+
+using URLPatterns = std::set<extensions::URLPattern>;
+
+// Tests URLs against a set of URL patterns without scanning all of them.
+//
+// The patterns are indexed by host when the matcher is built, so a lookup
+// only looks at the patterns for the URL's host and its parent domains, plus
+// the ones matching any host. Those candidates are filtered by scheme before
+// the full pattern is matched.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  explicit URLPatternMatcher(const URLPatterns& patterns);
+  ~URLPatternMatcher();
+
+  bool is_empty() const { return entries_.empty(); }
+
+  // Whether |url| matches any of the patterns.
+  bool MatchesURL(const GURL& url) const;
+
+ private:
+  struct Entry {
+    extensions::URLPattern pattern;
+    // Bit set of the known schemes matched by the pattern.
+    uint32_t schemes;
+  };
+
+  using Index = std::unordered_map<std::string, std::vector<size_t>>;
+
+  bool MatchesAny(const std::vector<size_t>& candidates,
+                  const GURL& url,
+                  uint32_t scheme) const;
+
+  std::vector<Entry> entries_;
+
+  // Patterns for one host, and patterns for a domain and its subdomains.
+  Index hosts_;
+  Index domains_;
+  // Patterns matching any host.
+  std::vector<size_t> any_host_;
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
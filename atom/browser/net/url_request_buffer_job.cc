@@ -34,9 +34,9 @@ URLRequestBufferJob::URLRequestBufferJob(
 
 void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
   const base::BinaryValue* binary = nullptr;
+  base::DictionaryValue* dict = nullptr;
   if (options->IsType(base::Value::TYPE_DICTIONARY)) {
-    base::DictionaryValue* dict =
-        static_cast<base::DictionaryValue*>(options.get());
+    dict = static_cast<base::DictionaryValue*>(options.get());
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
     dict->GetBinary("data", &binary);
@@ -63,6 +63,8 @@ void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
       reinterpret_cast<const unsigned char*>(binary->GetBuffer()),
       binary->GetSize());
   status_code_ = net::HTTP_OK;
+  if (dict && response_cache())
+    response_cache()->MaybePut(request(), *dict, mime_type_, charset_, data_);
   net::URLRequestSimpleJob::Start();
 }
 
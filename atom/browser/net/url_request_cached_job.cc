@@ -0,0 +1,69 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_cached_job.h"
+
+#include <string>
+
+#include "atom/common/atom_constants.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+URLRequestCachedJob::URLRequestCachedJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate,
+    const ProtocolResponseCache::Entry& entry)
+    : net::URLRequestSimpleJob(request, network_delegate),
+      entry_(entry) {
+}
+
+void URLRequestCachedJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  std::string status(IsNotModified() ? "HTTP/1.1 304 Not Modified"
+                                     : "HTTP/1.1 200 OK");
+  status.append("\0\0", 2);
+  auto* headers = new net::HttpResponseHeaders(status);
+
+  headers->AddHeader(kCORSHeader);
+
+  if (!entry_.mime_type.empty()) {
+    std::string content_type_header(net::HttpRequestHeaders::kContentType);
+    content_type_header.append(": ");
+    content_type_header.append(entry_.mime_type);
+    headers->AddHeader(content_type_header);
+  }
+
+  if (!entry_.etag.empty())
+    headers->AddHeader("ETag: " + entry_.etag);
+
+  info->headers = headers;
+}
+
+int URLRequestCachedJob::GetRefCountedData(
+    std::string* mime_type,
+    std::string* charset,
+    scoped_refptr<base::RefCountedMemory>* data,
+    const net::CompletionCallback& callback) const {
+  *mime_type = entry_.mime_type;
+  *charset = entry_.charset;
+  if (IsNotModified())
+    *data = new base::RefCountedString;
+  else
+    *data = entry_.data;
+  return net::OK;
+}
+
+bool URLRequestCachedJob::IsNotModified() const {
+  std::string if_none_match;
+  return !entry_.etag.empty() &&
+         request()->extra_request_headers().GetHeader(
+             net::HttpRequestHeaders::kIfNoneMatch, &if_none_match) &&
+         if_none_match == entry_.etag;
+}
+
+}  // namespace atom
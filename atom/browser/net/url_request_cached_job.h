@@ -0,0 +1,42 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_CACHED_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_CACHED_JOB_H_
+
+#include <string>
+
+#include "atom/browser/net/protocol_response_cache.h"
+#include "net/url_request/url_request_simple_job.h"
+
+namespace atom {
+
+// Serves a response of ProtocolResponseCache.
+class URLRequestCachedJob : public net::URLRequestSimpleJob {
+ public:
+  URLRequestCachedJob(net::URLRequest* request,
+                      net::NetworkDelegate* network_delegate,
+                      const ProtocolResponseCache::Entry& entry);
+
+  // URLRequestJob:
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+
+  // URLRequestSimpleJob:
+  int GetRefCountedData(std::string* mime_type,
+                        std::string* charset,
+                        scoped_refptr<base::RefCountedMemory>* data,
+                        const net::CompletionCallback& callback) const override;
+
+ private:
+  // Whether the request already has the response with the same ETag.
+  bool IsNotModified() const;
+
+  const ProtocolResponseCache::Entry entry_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestCachedJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_CACHED_JOB_H_
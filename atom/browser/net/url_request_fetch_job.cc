@@ -22,6 +22,9 @@ namespace atom {
 
 namespace {
 
+// The fetcher is blocked once this many bytes are waiting to be read.
+const int kMaxQueuedBytes = 512 * 1024;
+
 // Convert string to RequestType.
 net::URLFetcher::RequestType GetRequestType(const std::string& raw) {
   std::string method = base::ToUpperASCII(raw);
@@ -79,7 +82,9 @@ URLRequestFetchJob::URLRequestFetchJob(
     net::URLRequest* request, net::NetworkDelegate* network_delegate)
     : JsAsker<net::URLRequestJob>(request, network_delegate),
       pending_buffer_size_(0),
-      write_num_bytes_(0) {
+      queued_bytes_(0),
+      write_num_bytes_(0),
+      fetch_completed_(false) {
 }
 
 void URLRequestFetchJob::BeforeStartInUI(
@@ -172,16 +177,23 @@ int URLRequestFetchJob::DataAvailable(net::IOBuffer* buffer,
                                       int num_bytes,
                                       const net::CompletionCallback& callback) {
   // When pending_buffer_ is empty, there's no ReadRawData() operation waiting
-  // for IO completion, we have to save the parameters until the request is
-  // ready to read data.
+  // for IO completion, we keep the data until the request is ready to read it,
+  // and only make the fetcher wait when too much data is kept.
   if (!pending_buffer_.get()) {
+    if (queued_bytes_ < kMaxQueuedBytes) {
+      QueueChunk(buffer, num_bytes);
+      return num_bytes;
+    }
+
     write_buffer_ = buffer;
     write_num_bytes_ = num_bytes;
     write_callback_ = callback;
     return net::ERR_IO_PENDING;
   }
 
-  // Write data to the pending buffer and clear them after the writing.
+  // A pending read means the queue is empty, so write data to the pending
+  // buffer directly and clear them after the writing.
+  DCHECK(queued_chunks_.empty());
   int bytes_read = BufferCopy(buffer, num_bytes,
                               pending_buffer_.get(), pending_buffer_size_);
   ClearPendingBuffer();
@@ -200,21 +212,28 @@ int URLRequestFetchJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
     return net::OK;
   }
 
-  // When write_buffer_ is empty, there is no data valable yet, we have to save
-  // the dest buffer util DataAvailable.
-  if (!write_buffer_.get()) {
-    pending_buffer_ = dest;
-    pending_buffer_size_ = dest_size;
-    return net::ERR_IO_PENDING;
+  if (!queued_chunks_.empty()) {
+    int bytes_read = ReadQueuedChunks(dest, dest_size);
+
+    // There is room in the queue again, let the waiting fetcher continue.
+    if (write_buffer_.get() && queued_bytes_ < kMaxQueuedBytes) {
+      int bytes_written = write_num_bytes_;
+      QueueChunk(write_buffer_.get(), bytes_written);
+      net::CompletionCallback write_callback = write_callback_;
+      ClearWriteBuffer();
+      write_callback.Run(bytes_written);
+    }
+    return bytes_read;
   }
 
-  // Read from the write buffer and clear them after reading.
-  int bytes_read = BufferCopy(write_buffer_.get(), write_num_bytes_,
-                              dest, dest_size);
-  net::CompletionCallback write_callback = write_callback_;
-  ClearWriteBuffer();
-  write_callback.Run(bytes_read);
-  return bytes_read;
+  if (fetch_completed_)
+    return net::OK;
+
+  // When there is no data valable yet, we have to save the dest buffer util
+  // DataAvailable.
+  pending_buffer_ = dest;
+  pending_buffer_size_ = dest_size;
+  return net::ERR_IO_PENDING;
 }
 
 bool URLRequestFetchJob::GetMimeType(std::string* mime_type) const {
@@ -245,13 +264,19 @@ void URLRequestFetchJob::OnURLFetchComplete(const net::URLFetcher* source) {
     return;
   }
 
-  ClearPendingBuffer();
-  ClearWriteBuffer();
+  if (!fetcher_->GetStatus().is_success()) {
+    ClearPendingBuffer();
+    ClearWriteBuffer();
+    NotifyStartError(fetcher_->GetStatus());
+    return;
+  }
 
-  if (fetcher_->GetStatus().is_success())
+  // The queued data is still served by ReadRawData before the end of data.
+  fetch_completed_ = true;
+  if (pending_buffer_.get()) {
+    ClearPendingBuffer();
     ReadRawDataComplete(0);
-  else
-    NotifyStartError(fetcher_->GetStatus());
+  }
 }
 
 int URLRequestFetchJob::BufferCopy(net::IOBuffer* source, int num_bytes,
@@ -261,6 +286,31 @@ int URLRequestFetchJob::BufferCopy(net::IOBuffer* source, int num_bytes,
   return bytes_written;
 }
 
+void URLRequestFetchJob::QueueChunk(net::IOBuffer* source, int num_bytes) {
+  scoped_refptr<net::IOBufferWithSize> chunk(
+      new net::IOBufferWithSize(num_bytes));
+  memcpy(chunk->data(), source->data(), num_bytes);
+  queued_chunks_.push_back(new net::DrainableIOBuffer(chunk.get(), num_bytes));
+  queued_bytes_ += num_bytes;
+}
+
+int URLRequestFetchJob::ReadQueuedChunks(net::IOBuffer* target,
+                                         int target_size) {
+  int bytes_read = 0;
+  while (bytes_read < target_size && !queued_chunks_.empty()) {
+    net::DrainableIOBuffer* chunk = queued_chunks_.front().get();
+    int num_bytes = std::min(chunk->BytesRemaining(),
+                             target_size - bytes_read);
+    memcpy(target->data() + bytes_read, chunk->data(), num_bytes);
+    chunk->DidConsume(num_bytes);
+    bytes_read += num_bytes;
+    if (chunk->BytesRemaining() == 0)
+      queued_chunks_.pop_front();
+  }
+  queued_bytes_ -= bytes_read;
+  return bytes_read;
+}
+
 void URLRequestFetchJob::ClearPendingBuffer() {
   pending_buffer_ = nullptr;
   pending_buffer_size_ = 0;
@@ -5,10 +5,12 @@
 #ifndef ATOM_BROWSER_NET_URL_REQUEST_FETCH_JOB_H_
 #define ATOM_BROWSER_NET_URL_REQUEST_FETCH_JOB_H_
 
+#include <deque>
 #include <string>
 
 #include "atom/browser/net/js_asker.h"
 #include "browser/url_request_context_getter.h"
+#include "net/base/io_buffer.h"
 #include "net/url_request/url_fetcher_delegate.h"
 
 namespace atom {
@@ -43,6 +45,10 @@ class URLRequestFetchJob : public JsAsker<net::URLRequestJob>,
  private:
   int BufferCopy(net::IOBuffer* source, int num_bytes,
                  net::IOBuffer* target, int target_size);
+  // Copies |num_bytes| of |source| into the queue.
+  void QueueChunk(net::IOBuffer* source, int num_bytes);
+  // Moves queued data into |target|, returns the number of bytes moved.
+  int ReadQueuedChunks(net::IOBuffer* target, int target_size);
   void ClearPendingBuffer();
   void ClearWriteBuffer();
 
@@ -54,11 +60,19 @@ class URLRequestFetchJob : public JsAsker<net::URLRequestJob>,
   scoped_refptr<net::IOBuffer> pending_buffer_;
   int pending_buffer_size_;
 
-  // Saved arguments passed to DataAvailable.
+  // Data written by the fetcher while there was no pending read, so the
+  // fetcher can keep reading from network until the queue is full.
+  std::deque<scoped_refptr<net::DrainableIOBuffer>> queued_chunks_;
+  int queued_bytes_;
+
+  // Saved arguments passed to DataAvailable when the queue is full.
   scoped_refptr<net::IOBuffer> write_buffer_;
   int write_num_bytes_;
   net::CompletionCallback write_callback_;
 
+  // Whether the fetcher has written all data.
+  bool fetch_completed_;
+
   DISALLOW_COPY_AND_ASSIGN(URLRequestFetchJob);
 };
 
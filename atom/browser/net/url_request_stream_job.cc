@@ -0,0 +1,377 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_stream_job.h"
+
+#include <algorithm>
+#include <string>
+
+#include "atom/common/atom_constants.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/node_includes.h"
+#include "base/strings/string_number_conversions.h"
+#include "native_mate/dictionary.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_status_code.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// The stream is paused when this many bytes are waiting to be read by the
+// request, and resumed when half of them have been read.
+const int kMaxQueuedBytes = 256 * 1024;
+
+bool IsReadableStream(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  mate::Dictionary dict;
+  v8::Local<v8::Function> on, pause, resume;
+  return mate::ConvertFromV8(isolate, value, &dict) &&
+         dict.Get("on", &on) && dict.Get("pause", &pause) &&
+         dict.Get("resume", &resume);
+}
+
+}  // namespace
+
+// Reads a Readable stream on the UI thread and sends its chunks to the job,
+// deletes itself when the stream ends or the job is gone.
+class URLRequestStreamReader {
+ public:
+  URLRequestStreamReader(v8::Isolate* isolate,
+                         v8::Local<v8::Object> stream,
+                         base::WeakPtr<URLRequestStreamJob> job)
+      : isolate_(isolate),
+        stream_(isolate, stream),
+        job_(job),
+        queued_bytes_(0),
+        paused_(false),
+        weak_factory_(this) {
+    using DataCallback = base::Callback<void(v8::Local<v8::Value>)>;
+    using EndCallback = base::Callback<void()>;
+    // Adding a "data" listener switches the stream into flowing mode.
+    mate::CustomEmit(isolate, stream, "on", std::string("data"),
+        DataCallback(base::Bind(&URLRequestStreamReader::OnData,
+                                weak_factory_.GetWeakPtr())));
+    mate::CustomEmit(isolate, stream, "on", std::string("end"),
+        EndCallback(base::Bind(&URLRequestStreamReader::OnEnd,
+                               weak_factory_.GetWeakPtr(), net::OK)));
+    mate::CustomEmit(isolate, stream, "on", std::string("error"),
+        EndCallback(base::Bind(&URLRequestStreamReader::OnEnd,
+                               weak_factory_.GetWeakPtr(), net::ERR_FAILED)));
+  }
+
+  base::WeakPtr<URLRequestStreamReader> GetWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+  // Called when the job has read |num_bytes| of the queued data.
+  void OnConsumed(int num_bytes) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    queued_bytes_ -= num_bytes;
+    if (paused_ && queued_bytes_ <= kMaxQueuedBytes / 2) {
+      paused_ = false;
+      CallStreamMethod("resume");
+    }
+  }
+
+  // Called when the request has been cancelled.
+  void Cancel() {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    // Destroying the stream may emit "error" synchronously, which must not
+    // reach OnEnd.
+    weak_factory_.InvalidateWeakPtrs();
+    // Streams that can not be destroyed are left paused.
+    if (!CallStreamMethod("destroy"))
+      CallStreamMethod("pause");
+    delete this;
+  }
+
+ private:
+  ~URLRequestStreamReader() {}
+
+  void OnData(v8::Local<v8::Value> data) {
+    scoped_refptr<net::IOBufferWithSize> chunk;
+    if (node::Buffer::HasInstance(data)) {
+      chunk = new net::IOBufferWithSize(node::Buffer::Length(data));
+      memcpy(chunk->data(), node::Buffer::Data(data), chunk->size());
+    } else if (data->IsString()) {
+      std::string str;
+      mate::ConvertFromV8(isolate_, data, &str);
+      chunk = new net::IOBufferWithSize(str.size());
+      memcpy(chunk->data(), str.data(), str.size());
+    }
+    if (!chunk || chunk->size() == 0)
+      return;
+
+    queued_bytes_ += chunk->size();
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnStreamData, job_, chunk));
+
+    if (!paused_ && queued_bytes_ >= kMaxQueuedBytes) {
+      paused_ = true;
+      CallStreamMethod("pause");
+    }
+  }
+
+  void OnEnd(int error) {
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnStreamEnd, job_, error));
+    delete this;
+  }
+
+  // Calls |method| of the stream, returns false if there is no such method.
+  bool CallStreamMethod(const char* method) {
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Object> stream = v8::Local<v8::Object>::New(isolate_,
+                                                              stream_);
+    v8::Context::Scope context_scope(stream->CreationContext());
+    mate::Dictionary dict(isolate_, stream);
+    v8::Local<v8::Function> function;
+    if (!dict.Get(method, &function))
+      return false;
+    // Use node::MakeCallback so the ticks scheduled by the stream are run.
+    node::MakeCallback(isolate_, stream, function, 0, nullptr);
+    return true;
+  }
+
+  v8::Isolate* isolate_;
+  v8::Global<v8::Object> stream_;
+  base::WeakPtr<URLRequestStreamJob> job_;
+
+  // Bytes sent to the job that it has not read yet.
+  int queued_bytes_;
+  bool paused_;
+
+  base::WeakPtrFactory<URLRequestStreamReader> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamReader);
+};
+
+URLRequestStreamJob::ReaderState::ReaderState() : killed_(false) {
+}
+
+URLRequestStreamJob::ReaderState::~ReaderState() {
+}
+
+bool URLRequestStreamJob::ReaderState::SetReader(
+    base::WeakPtr<URLRequestStreamReader> reader) {
+  base::AutoLock auto_lock(lock_);
+  if (killed_)
+    return false;
+  reader_ = reader;
+  return true;
+}
+
+base::WeakPtr<URLRequestStreamReader>
+URLRequestStreamJob::ReaderState::GetReader() {
+  base::AutoLock auto_lock(lock_);
+  return reader_;
+}
+
+base::WeakPtr<URLRequestStreamReader>
+URLRequestStreamJob::ReaderState::Kill() {
+  base::AutoLock auto_lock(lock_);
+  killed_ = true;
+  base::WeakPtr<URLRequestStreamReader> reader = reader_;
+  reader_.reset();
+  return reader;
+}
+
+URLRequestStreamJob::URLRequestStreamJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate)
+    : JsAsker<net::URLRequestJob>(request, network_delegate),
+      start_error_(net::ERR_NOT_IMPLEMENTED),
+      reader_state_(new ReaderState),
+      chunk_offset_(0),
+      ended_(false),
+      end_error_(net::OK),
+      pending_buffer_size_(0),
+      weak_ptr_factory_(this) {
+  // The reader gets this pointer on the UI thread, so create it here.
+  weak_this_ = weak_ptr_factory_.GetWeakPtr();
+}
+
+URLRequestStreamJob::~URLRequestStreamJob() {
+  CancelReader();
+}
+
+void URLRequestStreamJob::OnStreamData(
+    scoped_refptr<net::IOBufferWithSize> chunk) {
+  chunks_.push_back(chunk);
+  if (!pending_buffer_.get())
+    return;
+
+  int bytes_read = CopyQueuedData(pending_buffer_.get(), pending_buffer_size_);
+  pending_buffer_ = nullptr;
+  pending_buffer_size_ = 0;
+  ReadRawDataComplete(bytes_read);
+}
+
+void URLRequestStreamJob::OnStreamEnd(int error) {
+  ended_ = true;
+  end_error_ = error;
+  reader_.reset();
+  if (!pending_buffer_.get())
+    return;
+
+  pending_buffer_ = nullptr;
+  pending_buffer_size_ = 0;
+  ReadRawDataComplete(error);
+}
+
+bool URLRequestStreamJob::ShouldConvertOptions() const {
+  // The stream is read in BeforeStartInUI, converting it to base::Value would
+  // copy its whole object graph.
+  return false;
+}
+
+void URLRequestStreamJob::BeforeStartInUI(
+    v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  int status_code = net::HTTP_OK;
+  std::string mime_type;
+  base::DictionaryValue headers;
+  v8::Local<v8::Value> stream = value;
+
+  mate::Dictionary options;
+  if (value->IsNumber()) {
+    mate::ConvertFromV8(isolate, value, &start_error_);
+    return;
+  } else if (!IsReadableStream(isolate, value) &&
+             mate::ConvertFromV8(isolate, value, &options)) {
+    if (options.Get("error", &start_error_))
+      return;
+    options.Get("statusCode", &status_code);
+    options.Get("mimeType", &mime_type);
+    options.Get("headers", &headers);
+    options.Get("data", &stream);
+  }
+
+  if (!IsReadableStream(isolate, stream))
+    return;
+
+  std::string status("HTTP/1.1 ");
+  status.append(base::IntToString(status_code));
+  status.append(" ");
+  status.append(
+      net::GetHttpReasonPhrase(static_cast<net::HttpStatusCode>(status_code)));
+  status.append("\0\0", 2);
+  response_headers_ = new net::HttpResponseHeaders(status);
+  response_headers_->AddHeader(kCORSHeader);
+  if (!mime_type.empty()) {
+    std::string content_type_header(net::HttpRequestHeaders::kContentType);
+    content_type_header.append(": ");
+    content_type_header.append(mime_type);
+    response_headers_->AddHeader(content_type_header);
+  }
+  for (base::DictionaryValue::Iterator it(headers); !it.IsAtEnd();
+       it.Advance()) {
+    std::string header_value;
+    if (it.value().GetAsString(&header_value))
+      response_headers_->AddHeader(it.key() + ": " + header_value);
+  }
+
+  // The job may have been killed on the IO thread in the meantime, in which
+  // case the reader destroys the stream right away.
+  auto* reader = new URLRequestStreamReader(
+      isolate, stream.As<v8::Object>(), weak_this_);
+  if (!reader_state_->SetReader(reader->GetWeakPtr())) {
+    reader->Cancel();
+    return;
+  }
+  start_error_ = net::OK;
+}
+
+void URLRequestStreamJob::StartAsync(std::unique_ptr<base::Value> options) {
+  reader_ = reader_state_->GetReader();
+  if (start_error_ != net::OK) {
+    NotifyStartError(net::URLRequestStatus(
+          net::URLRequestStatus::FAILED, start_error_));
+    return;
+  }
+
+  NotifyHeadersComplete();
+}
+
+void URLRequestStreamJob::Kill() {
+  CancelReader();
+  // Drop the OnStreamData and OnStreamEnd tasks already posted by the reader.
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  pending_buffer_ = nullptr;
+  pending_buffer_size_ = 0;
+  JsAsker<URLRequestJob>::Kill();
+}
+
+int URLRequestStreamJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
+  if (!chunks_.empty())
+    return CopyQueuedData(dest, dest_size);
+
+  if (ended_)
+    return end_error_;
+
+  // No data available yet, save the dest buffer until OnStreamData.
+  pending_buffer_ = dest;
+  pending_buffer_size_ = dest_size;
+  return net::ERR_IO_PENDING;
+}
+
+bool URLRequestStreamJob::GetMimeType(std::string* mime_type) const {
+  if (!response_headers_)
+    return false;
+
+  return response_headers_->GetMimeType(mime_type);
+}
+
+void URLRequestStreamJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  info->headers = response_headers_;
+}
+
+int URLRequestStreamJob::GetResponseCode() const {
+  if (!response_headers_)
+    return -1;
+
+  return response_headers_->response_code();
+}
+
+int URLRequestStreamJob::CopyQueuedData(net::IOBuffer* dest, int dest_size) {
+  int bytes_copied = 0;
+  int bytes_consumed = 0;
+  while (bytes_copied < dest_size && !chunks_.empty()) {
+    net::IOBufferWithSize* chunk = chunks_.front().get();
+    int num_bytes = std::min(chunk->size() - chunk_offset_,
+                             dest_size - bytes_copied);
+    memcpy(dest->data() + bytes_copied, chunk->data() + chunk_offset_,
+           num_bytes);
+    bytes_copied += num_bytes;
+    chunk_offset_ += num_bytes;
+
+    if (chunk_offset_ == chunk->size()) {
+      bytes_consumed += chunk->size();
+      chunks_.pop_front();
+      chunk_offset_ = 0;
+    }
+  }
+
+  if (bytes_consumed > 0) {
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&URLRequestStreamReader::OnConsumed, reader_,
+                   bytes_consumed));
+  }
+  return bytes_copied;
+}
+
+void URLRequestStreamJob::CancelReader() {
+  // The reader lives on the UI thread, so it is only checked there.
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&URLRequestStreamReader::Cancel, reader_state_->Kill()));
+  reader_.reset();
+}
+
+}  // namespace atom
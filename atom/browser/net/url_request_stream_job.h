@@ -0,0 +1,107 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+
+#include <deque>
+#include <string>
+
+#include "atom/browser/net/js_asker.h"
+#include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
+#include "net/base/io_buffer.h"
+
+namespace atom {
+
+class URLRequestStreamReader;
+
+// Serves the body from a Readable stream returned by the JavaScript handler.
+//
+// The stream is read on the UI thread and its chunks are queued here until
+// ReadRawData asks for them. When too many bytes are queued the stream is
+// paused, and it is resumed once the request has consumed them.
+class URLRequestStreamJob : public JsAsker<net::URLRequestJob> {
+ public:
+  URLRequestStreamJob(net::URLRequest*, net::NetworkDelegate*);
+  ~URLRequestStreamJob() override;
+
+  // Called by the stream reader.
+  void OnStreamData(scoped_refptr<net::IOBufferWithSize> chunk);
+  void OnStreamEnd(int error);
+
+ protected:
+  // JsAsker:
+  bool ShouldConvertOptions() const override;
+  void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) override;
+  void StartAsync(std::unique_ptr<base::Value> options) override;
+
+  // net::URLRequestJob:
+  void Kill() override;
+  int ReadRawData(net::IOBuffer* buf, int buf_size) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+  int GetResponseCode() const override;
+
+ private:
+  // The reader is created on the UI thread while the job may be killed on the
+  // IO thread at any time, this is what both threads need to know about it.
+  class ReaderState : public base::RefCountedThreadSafe<ReaderState> {
+   public:
+    ReaderState();
+
+    // Called on the UI thread, returns false when the job has been killed and
+    // the reader must be cancelled.
+    bool SetReader(base::WeakPtr<URLRequestStreamReader> reader);
+    // Called on the IO thread.
+    base::WeakPtr<URLRequestStreamReader> GetReader();
+    // Marks the job as killed and returns the reader to cancel, if any.
+    base::WeakPtr<URLRequestStreamReader> Kill();
+
+   private:
+    friend class base::RefCountedThreadSafe<ReaderState>;
+    ~ReaderState();
+
+    base::Lock lock_;
+    bool killed_;
+    base::WeakPtr<URLRequestStreamReader> reader_;
+
+    DISALLOW_COPY_AND_ASSIGN(ReaderState);
+  };
+
+  // Moves queued data into |dest|, and tells the reader about every chunk
+  // that has been consumed completely.
+  int CopyQueuedData(net::IOBuffer* dest, int dest_size);
+
+  // Stops reading the stream.
+  void CancelReader();
+
+  // Set by BeforeStartInUI.
+  int start_error_;
+  scoped_refptr<net::HttpResponseHeaders> response_headers_;
+  scoped_refptr<ReaderState> reader_state_;
+
+  // Taken from |reader_state_| when the job starts, only used on the IO
+  // thread.
+  base::WeakPtr<URLRequestStreamReader> reader_;
+
+  // Chunks received from the stream but not read yet.
+  std::deque<scoped_refptr<net::IOBufferWithSize>> chunks_;
+  int chunk_offset_;
+  bool ended_;
+  int end_error_;
+
+  // Saved arguments passed to ReadRawData.
+  scoped_refptr<net::IOBuffer> pending_buffer_;
+  int pending_buffer_size_;
+
+  base::WeakPtr<URLRequestStreamJob> weak_this_;
+  base::WeakPtrFactory<URLRequestStreamJob> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
@@ -23,6 +23,11 @@ void URLRequestStringJob::StartAsync(std::unique_ptr<base::Value> options) {
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
     dict->GetString("data", &data_);
+    if (response_cache() && dict->HasKey("cache")) {
+      std::string data(data_);
+      response_cache()->MaybePut(request(), *dict, mime_type_, charset_,
+                                 base::RefCountedString::TakeString(&data));
+    }
   } else if (options->IsType(base::Value::TYPE_STRING)) {
     options->GetAsString(&data_);
   }
@@ -0,0 +1,30 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_worker_job.h"
+
+#include <utility>
+
+namespace atom {
+
+URLRequestWorkerJob::URLRequestWorkerJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate,
+    scoped_refptr<ProtocolWorkerPool> worker_pool,
+    ProtocolResponseCache* response_cache)
+    : URLRequestBufferJob(request, network_delegate),
+      worker_pool_(worker_pool) {
+  set_response_cache(response_cache);
+}
+
+URLRequestWorkerJob::~URLRequestWorkerJob() {
+}
+
+void URLRequestWorkerJob::AskForOptions(
+    std::unique_ptr<base::DictionaryValue> request_details,
+    const internal::ResponseCallback& callback) {
+  worker_pool_->HandleRequest(std::move(request_details), callback);
+}
+
+}  // namespace atom
@@ -0,0 +1,38 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_WORKER_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_WORKER_JOB_H_
+
+#include <memory>
+
+#include "atom/browser/net/protocol_worker_pool.h"
+#include "atom/browser/net/url_request_buffer_job.h"
+
+namespace atom {
+
+// A buffer job whose options come from a ProtocolWorkerPool instead of the
+// JavaScript handler on the UI thread.
+class URLRequestWorkerJob : public URLRequestBufferJob {
+ public:
+  URLRequestWorkerJob(net::URLRequest* request,
+                      net::NetworkDelegate* network_delegate,
+                      scoped_refptr<ProtocolWorkerPool> worker_pool,
+                      ProtocolResponseCache* response_cache);
+  ~URLRequestWorkerJob() override;
+
+ protected:
+  // JsAsker:
+  void AskForOptions(std::unique_ptr<base::DictionaryValue> request_details,
+                     const internal::ResponseCallback& callback) override;
+
+ private:
+  scoped_refptr<ProtocolWorkerPool> worker_pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestWorkerJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_WORKER_JOB_H_
@@ -0,0 +1,95 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/web_request_rules.h"
+
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+
+namespace atom {
+
+WebRequestRule::WebRequestRule() : cancel(false) {
+}
+
+WebRequestRule::WebRequestRule(const WebRequestRule& other) = default;
+
+WebRequestRule::~WebRequestRule() {
+}
+
+WebRequestRules::WebRequestRules() {
+}
+
+WebRequestRules::WebRequestRules(const std::vector<WebRequestRule>& rules) {
+  rules_.reserve(rules.size());
+  for (const auto& rule : rules)
+    rules_.push_back({ URLPatternMatcher(rule.url_patterns), rule });
+}
+
+WebRequestRules::~WebRequestRules() {
+}
+
+int WebRequestRules::OnBeforeRequest(const GURL& url, GURL* new_url) const {
+  for (const auto& it : rules_) {
+    const WebRequestRule& rule = it.rule;
+    if (!rule.cancel && rule.redirect_url.is_empty())
+      continue;
+    if (!Matches(it, url))
+      continue;
+
+    if (rule.cancel)
+      return net::ERR_BLOCKED_BY_CLIENT;
+    // Do not redirect a request that already went to the target, in case the
+    // target is matched by the rule too.
+    if (rule.redirect_url != url) {
+      *new_url = rule.redirect_url;
+      return net::OK;
+    }
+  }
+  return net::OK;
+}
+
+void WebRequestRules::OnBeforeSendHeaders(
+    const GURL& url, net::HttpRequestHeaders* headers) const {
+  for (const auto& it : rules_) {
+    const WebRequestRule& rule = it.rule;
+    if (rule.remove_request_headers.empty() && rule.add_request_headers.empty())
+      continue;
+    if (!Matches(it, url))
+      continue;
+
+    for (const auto& name : rule.remove_request_headers)
+      headers->RemoveHeader(name);
+    for (const auto& header : rule.add_request_headers)
+      headers->SetHeader(header.first, header.second);
+  }
+}
+
+void WebRequestRules::OnHeadersReceived(
+    const GURL& url,
+    const net::HttpResponseHeaders* original_headers,
+    scoped_refptr<net::HttpResponseHeaders>* override_headers) const {
+  for (const auto& it : rules_) {
+    const WebRequestRule& rule = it.rule;
+    if (rule.remove_response_headers.empty() &&
+        rule.add_response_headers.empty())
+      continue;
+    if (!Matches(it, url))
+      continue;
+
+    if (!override_headers->get())
+      *override_headers =
+          new net::HttpResponseHeaders(original_headers->raw_headers());
+    for (const auto& name : rule.remove_response_headers)
+      (*override_headers)->RemoveHeader(name);
+    for (const auto& header : rule.add_response_headers)
+      (*override_headers)->AddHeader(header.first + ": " + header.second);
+  }
+}
+
+bool WebRequestRules::Matches(const CompiledRule& rule, const GURL& url) const {
+  return rule.url_patterns.is_empty() || rule.url_patterns.MatchesURL(url);
+}
+
+}  // namespace atom
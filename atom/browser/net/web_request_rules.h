@@ -0,0 +1,77 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <string>
+#include <vector>
+
+#include "atom/browser/net/url_pattern_matcher.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_split.h"
+#include "url/gurl.h"
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+}
+
+namespace atom {
+
+// A rule set by webRequest.setRules.
+struct WebRequestRule {
+  WebRequestRule();
+  WebRequestRule(const WebRequestRule& other);
+  ~WebRequestRule();
+
+  URLPatterns url_patterns;
+  bool cancel;
+  GURL redirect_url;
+  base::StringPairs add_request_headers;
+  std::vector<std::string> remove_request_headers;
+  base::StringPairs add_response_headers;
+  std::vector<std::string> remove_response_headers;
+};
+
+// Applies the rules to requests on the IO thread, without asking JavaScript.
+//
+// The first matching rule that cancels or redirects decides the fate of a
+// request, while the header changes of all matching rules are applied in
+// order.
+class WebRequestRules {
+ public:
+  WebRequestRules();
+  explicit WebRequestRules(const std::vector<WebRequestRule>& rules);
+  ~WebRequestRules();
+
+  bool empty() const { return rules_.empty(); }
+
+  // Returns net::ERR_BLOCKED_BY_CLIENT when the request is canceled, and
+  // sets |new_url| when it is redirected.
+  int OnBeforeRequest(const GURL& url, GURL* new_url) const;
+
+  void OnBeforeSendHeaders(const GURL& url,
+                           net::HttpRequestHeaders* headers) const;
+
+  // Sets |override_headers| when the response headers are changed.
+  void OnHeadersReceived(
+      const GURL& url,
+      const net::HttpResponseHeaders* original_headers,
+      scoped_refptr<net::HttpResponseHeaders>* override_headers) const;
+
+ private:
+  struct CompiledRule {
+    URLPatternMatcher url_patterns;
+    WebRequestRule rule;
+  };
+
+  bool Matches(const CompiledRule& rule, const GURL& url) const;
+
+  std::vector<CompiledRule> rules_;
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
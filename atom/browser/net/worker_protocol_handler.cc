@@ -0,0 +1,36 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/worker_protocol_handler.h"
+
+#include "atom/browser/net/url_request_cached_job.h"
+#include "atom/browser/net/url_request_worker_job.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+WorkerProtocolHandler::WorkerProtocolHandler(
+    scoped_refptr<ProtocolWorkerPool> pool)
+    : worker_pool_(pool),
+      response_cache_(new ProtocolResponseCache) {
+}
+
+WorkerProtocolHandler::~WorkerProtocolHandler() {
+}
+
+net::URLRequestJob* WorkerProtocolHandler::MaybeCreateJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate) const {
+  if (request->method() == "GET") {
+    const ProtocolResponseCache::Entry* entry =
+        response_cache_->Get(request->url());
+    if (entry)
+      return new URLRequestCachedJob(request, network_delegate, *entry);
+  }
+
+  return new URLRequestWorkerJob(request, network_delegate, worker_pool_,
+                                 response_cache_.get());
+}
+
+}  // namespace atom
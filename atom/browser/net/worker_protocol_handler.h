@@ -0,0 +1,35 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WORKER_PROTOCOL_HANDLER_H_
+#define ATOM_BROWSER_NET_WORKER_PROTOCOL_HANDLER_H_
+
+#include "atom/browser/net/protocol_response_cache.h"
+#include "atom/browser/net/protocol_worker_pool.h"
+#include "net/url_request/url_request_job_factory.h"
+
+namespace atom {
+
+// Creates the jobs of a protocol registered with registerWorkerProtocol.
+class WorkerProtocolHandler
+    : public net::URLRequestJobFactory::ProtocolHandler {
+ public:
+  explicit WorkerProtocolHandler(scoped_refptr<ProtocolWorkerPool> pool);
+  ~WorkerProtocolHandler() override;
+
+  // net::URLRequestJobFactory::ProtocolHandler:
+  net::URLRequestJob* MaybeCreateJob(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate) const override;
+
+ private:
+  scoped_refptr<ProtocolWorkerPool> worker_pool_;
+  scoped_refptr<ProtocolResponseCache> response_cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerProtocolHandler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WORKER_PROTOCOL_HANDLER_H_
@@ -0,0 +1,191 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/osr/osr_frame_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/trace_event/trace_event.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace atom {
+
+namespace {
+
+OffScreenFrameScheduler* g_scheduler = nullptr;
+
+}  // namespace
+
+OffScreenFrameScheduler::ClientState::ClientState()
+    : active(false),
+      priority(0),
+      skipped(0) {
+}
+
+// static
+OffScreenFrameScheduler* OffScreenFrameScheduler::GetInstance() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!g_scheduler)
+    g_scheduler = new OffScreenFrameScheduler;
+  return g_scheduler;
+}
+
+OffScreenFrameScheduler::OffScreenFrameScheduler()
+    : time_source_(new cc::DelayBasedTimeSource(
+          content::BrowserThread::GetMessageLoopProxyForThread(
+              content::BrowserThread::UI).get())) {
+  time_source_->SetClient(this);
+}
+
+OffScreenFrameScheduler::~OffScreenFrameScheduler() {
+}
+
+void OffScreenFrameScheduler::AddClient(Client* client,
+                                        base::TimeDelta interval) {
+  DCHECK(!HasClient(client));
+  clients_[client].interval = interval;
+}
+
+void OffScreenFrameScheduler::RemoveClient(Client* client) {
+  clients_.erase(client);
+  UpdateTimer();
+}
+
+bool OffScreenFrameScheduler::HasClient(Client* client) const {
+  return clients_.find(client) != clients_.end();
+}
+
+void OffScreenFrameScheduler::SetActive(Client* client, bool active) {
+  ClientState* state = GetState(client);
+  if (!state || state->active == active)
+    return;
+
+  state->active = active;
+  // Start with the next tick, so newly active clients join the shared phase.
+  state->next_frame_time = base::TimeTicks();
+  UpdateTimer();
+}
+
+void OffScreenFrameScheduler::SetInterval(Client* client,
+                                          base::TimeDelta interval) {
+  ClientState* state = GetState(client);
+  if (!state || state->interval == interval)
+    return;
+
+  state->interval = interval;
+  UpdateTimer();
+}
+
+void OffScreenFrameScheduler::SetPriority(Client* client, int priority) {
+  ClientState* state = GetState(client);
+  if (state)
+    state->priority = priority;
+}
+
+void OffScreenFrameScheduler::SetClientFrameBudget(Client* client,
+                                                   base::TimeDelta budget) {
+  ClientState* state = GetState(client);
+  if (state)
+    state->budget = budget;
+}
+
+void OffScreenFrameScheduler::DidPaint(Client* client, base::TimeDelta cost) {
+  ClientState* state = GetState(client);
+  if (!state)
+    return;
+
+  state->last_cost = cost;
+
+  // Skip one frame for every budget the paint has used up.
+  if (!state->budget.is_zero() && cost > state->budget) {
+    int64_t skipped = cost.InMicroseconds() / state->budget.InMicroseconds();
+    state->next_frame_time += state->interval * skipped;
+  }
+}
+
+void OffScreenFrameScheduler::SetFrameBudget(base::TimeDelta budget) {
+  frame_budget_ = budget;
+}
+
+void OffScreenFrameScheduler::OnTimerTick() {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  // Clients that become due before the middle of the next tick are served
+  // now, otherwise timer jitter would make them miss a whole tick.
+  const base::TimeTicks deadline = now + tick_interval_ / 2;
+
+  std::vector<std::pair<Client*, ClientState*>> due;
+  for (auto& it : clients_) {
+    if (it.second.active && it.second.next_frame_time <= deadline)
+      due.push_back(std::make_pair(it.first, &it.second));
+  }
+  if (due.empty())
+    return;
+
+  TRACE_EVENT1("electron", "OffScreenFrameScheduler::OnTimerTick",
+               "due", due.size());
+
+  // Higher priority first, raised by the ticks a client has been skipped,
+  // then the client that waited longest.
+  std::sort(due.begin(), due.end(),
+            [](const std::pair<Client*, ClientState*>& a,
+               const std::pair<Client*, ClientState*>& b) {
+    int a_priority = a.second->priority + a.second->skipped;
+    int b_priority = b.second->priority + b.second->skipped;
+    if (a_priority != b_priority)
+      return a_priority > b_priority;
+    return a.second->last_frame_time < b.second->last_frame_time;
+  });
+
+  base::TimeDelta spent;
+  size_t served = 0;
+  bool over_budget = false;
+  for (const auto& it : due) {
+    ClientState* state = it.second;
+    // Always serve at least one client so a tiny budget can not starve all.
+    if (over_budget || (!frame_budget_.is_zero() && served > 0 &&
+                        spent + state->last_cost > frame_budget_)) {
+      over_budget = true;
+      ++state->skipped;
+      continue;
+    }
+
+    spent += state->last_cost;
+    ++served;
+
+    state->skipped = 0;
+    state->last_frame_time = now;
+    state->next_frame_time = std::max(state->next_frame_time, now) +
+                             state->interval;
+    it.first->OnBeginFrame(now, state->interval);
+  }
+}
+
+void OffScreenFrameScheduler::UpdateTimer() {
+  base::TimeDelta interval = base::TimeDelta::Max();
+  for (const auto& it : clients_) {
+    if (it.second.active)
+      interval = std::min(interval, it.second.interval);
+  }
+
+  if (interval == base::TimeDelta::Max()) {
+    time_source_->SetActive(false);
+    return;
+  }
+
+  if (interval != tick_interval_) {
+    tick_interval_ = interval;
+    time_source_->SetTimebaseAndInterval(base::TimeTicks::Now(), interval);
+  }
+  time_source_->SetActive(true);
+}
+
+OffScreenFrameScheduler::ClientState* OffScreenFrameScheduler::GetState(
+    Client* client) {
+  auto it = clients_.find(client);
+  return it == clients_.end() ? nullptr : &it->second;
+}
+
+}  // namespace atom
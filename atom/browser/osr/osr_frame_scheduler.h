@@ -0,0 +1,96 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_OSR_OSR_FRAME_SCHEDULER_H_
+#define ATOM_BROWSER_OSR_OSR_FRAME_SCHEDULER_H_
+
+#include <map>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "cc/scheduler/delay_based_time_source.h"
+
+namespace atom {
+
+// Drives the BeginFrames of all offscreen views from one timer on the UI
+// thread, so views that share a frame rate are ticked in the same task
+// instead of waking the UI thread at random phases.
+//
+// When the total paint cost of a tick exceeds the frame budget, only part of
+// the due views get a frame, picked by priority and then round-robin. Each
+// tick a view is skipped raises its priority by one until it is served, so
+// low priority views are slowed down but never starved.
+class OffScreenFrameScheduler : public cc::DelayBasedTimeSourceClient {
+ public:
+  class Client {
+   public:
+    virtual void OnBeginFrame(base::TimeTicks frame_time,
+                              base::TimeDelta interval) = 0;
+
+   protected:
+    virtual ~Client() {}
+  };
+
+  static OffScreenFrameScheduler* GetInstance();
+
+  void AddClient(Client* client, base::TimeDelta interval);
+  void RemoveClient(Client* client);
+  bool HasClient(Client* client) const;
+
+  void SetActive(Client* client, bool active);
+  void SetInterval(Client* client, base::TimeDelta interval);
+
+  // Clients with higher priority are served first when over budget.
+  void SetPriority(Client* client, int priority);
+
+  // A client whose paints take longer than its own budget gets fewer frames.
+  // An empty budget means no limit.
+  void SetClientFrameBudget(Client* client, base::TimeDelta budget);
+
+  // Reports how long the client spent painting its last frame.
+  void DidPaint(Client* client, base::TimeDelta cost);
+
+  // Limits the summed paint cost of all clients in one tick.
+  void SetFrameBudget(base::TimeDelta budget);
+  base::TimeDelta frame_budget() const { return frame_budget_; }
+
+ private:
+  struct ClientState {
+    ClientState();
+
+    bool active;
+    int priority;
+    // Ticks the client was due but skipped for the budget.
+    int skipped;
+    base::TimeDelta interval;
+    base::TimeDelta budget;
+    base::TimeDelta last_cost;
+    base::TimeTicks next_frame_time;
+    base::TimeTicks last_frame_time;
+  };
+
+  OffScreenFrameScheduler();
+  ~OffScreenFrameScheduler() override;
+
+  // cc::DelayBasedTimeSourceClient:
+  void OnTimerTick() override;
+
+  // Ticks at the shortest interval among active clients, stops when there is
+  // no active client.
+  void UpdateTimer();
+
+  ClientState* GetState(Client* client);
+
+  std::map<Client*, ClientState> clients_;
+  std::unique_ptr<cc::DelayBasedTimeSource> time_source_;
+  base::TimeDelta tick_interval_;
+  base::TimeDelta frame_budget_;
+
+  DISALLOW_COPY_AND_ASSIGN(OffScreenFrameScheduler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_OSR_OSR_FRAME_SCHEDULER_H_
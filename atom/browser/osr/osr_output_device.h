@@ -27,6 +27,9 @@ class OffScreenOutputDevice : public cc::SoftwareOutputDevice {
   void SetActive(bool active);
   void OnPaint(const gfx::Rect& damage_rect);
 
+ protected:
+  SkBitmap* bitmap() const { return bitmap_.get(); }
+
  private:
   const bool transparent_;
   OnPaintCallback callback_;
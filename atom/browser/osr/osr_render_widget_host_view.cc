@@ -4,15 +4,17 @@
 
 #include "atom/browser/osr/osr_render_widget_host_view.h"
 
+#include <algorithm>
 #include <vector>
 
+#include "atom/browser/osr/osr_tiled_output_device.h"
 #include "base/callback_helpers.h"
 #include "base/location.h"
 #include "base/memory/ptr_util.h"
 #include "base/single_thread_task_runner.h"
 #include "base/time/time.h"
 #include "cc/output/copy_output_request.h"
-#include "cc/scheduler/delay_based_time_source.h"
+#include "cc/quads/render_pass_draw_quad.h"
 #include "components/display_compositor/gl_helper.h"
 #include "content/browser/renderer_host/render_widget_host_delegate.h"
 #include "content/browser/renderer_host/render_widget_host_impl.h"
@@ -33,6 +35,20 @@ namespace {
 const float kDefaultScaleFactor = 1.0;
 const int kFrameRetryLimit = 2;
 
+// Whether a pass of |frame| draws with background filters, which read back
+// the pixels under them.
+bool HasBackgroundFilters(const cc::DelegatedFrameData& frame) {
+  for (const auto& pass : frame.render_pass_list) {
+    for (const cc::DrawQuad* quad : pass->quad_list) {
+      if (quad->material == cc::DrawQuad::RENDER_PASS &&
+          !cc::RenderPassDrawQuad::MaterialCast(quad)
+               ->background_filters.IsEmpty())
+        return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 class AtomCopyFrameGenerator {
@@ -296,44 +312,9 @@ class AtomCopyFrameGenerator {
   DISALLOW_COPY_AND_ASSIGN(AtomCopyFrameGenerator);
 };
 
-class AtomBeginFrameTimer : public cc::DelayBasedTimeSourceClient {
- public:
-  AtomBeginFrameTimer(int frame_rate_threshold_ms,
-                      const base::Closure& callback)
-      : callback_(callback) {
-    time_source_.reset(new cc::DelayBasedTimeSource(
-        content::BrowserThread::GetMessageLoopProxyForThread(
-          content::BrowserThread::UI).get()));
-    time_source_->SetClient(this);
-  }
-
-  void SetActive(bool active) {
-    time_source_->SetActive(active);
-  }
-
-  bool IsActive() const {
-    return time_source_->Active();
-  }
-
-  void SetFrameRateThresholdMs(int frame_rate_threshold_ms) {
-    time_source_->SetTimebaseAndInterval(
-        base::TimeTicks::Now(),
-        base::TimeDelta::FromMilliseconds(frame_rate_threshold_ms));
-  }
-
- private:
-  void OnTimerTick() override {
-    callback_.Run();
-  }
-
-  const base::Closure callback_;
-  std::unique_ptr<cc::DelayBasedTimeSource> time_source_;
-
-  DISALLOW_COPY_AND_ASSIGN(AtomBeginFrameTimer);
-};
-
 OffScreenRenderWidgetHostView::OffScreenRenderWidgetHostView(
     bool transparent,
+    bool tiled,
     const OnPaintCallback& callback,
     content::RenderWidgetHost* host,
     NativeWindow* native_window)
@@ -341,9 +322,14 @@ OffScreenRenderWidgetHostView::OffScreenRenderWidgetHostView(
       native_window_(native_window),
       software_output_device_(nullptr),
       transparent_(transparent),
+      tiled_(tiled),
       callback_(callback),
+      pending_readbacks_(0),
+      has_frame_subscriber_(false),
+      has_background_filters_(false),
       frame_rate_(60),
       frame_rate_threshold_ms_(0),
+      frame_priority_(0),
       last_time_(base::Time::Now()),
       scale_factor_(kDefaultScaleFactor),
       is_showing_(!render_widget_host_->is_hidden()),
@@ -380,6 +366,8 @@ OffScreenRenderWidgetHostView::~OffScreenRenderWidgetHostView() {
   if (native_window_)
     native_window_->RemoveObserver(this);
 
+  OffScreenFrameScheduler::GetInstance()->RemoveClient(this);
+
 #if defined(OS_MACOSX)
   if (is_showing_)
     browser_compositor_->SetRenderWidgetHostIsHidden(true);
@@ -396,11 +384,9 @@ OffScreenRenderWidgetHostView::~OffScreenRenderWidgetHostView() {
 #endif
 }
 
-void OffScreenRenderWidgetHostView::OnBeginFrameTimerTick() {
-  const base::TimeTicks frame_time = base::TimeTicks::Now();
-  const base::TimeDelta vsync_period =
-      base::TimeDelta::FromMilliseconds(frame_rate_threshold_ms_);
-  SendBeginFrame(frame_time, vsync_period);
+void OffScreenRenderWidgetHostView::OnBeginFrame(
+    base::TimeTicks frame_time, base::TimeDelta interval) {
+  SendBeginFrame(frame_time, interval);
 }
 
 void OffScreenRenderWidgetHostView::SendBeginFrame(
@@ -560,9 +546,14 @@ void OffScreenRenderWidgetHostView::OnSwapCompositorFrame(
 
   if (frame.delegated_frame_data) {
     if (software_output_device_) {
-      if (!begin_frame_timer_.get()) {
+      if (!OffScreenFrameScheduler::GetInstance()->HasClient(this)) {
         software_output_device_->SetActive(painting_);
       }
+      if (tiled_) {
+        has_background_filters_ =
+            HasBackgroundFilters(*frame.delegated_frame_data);
+        UpdateTiledPainting();
+      }
 
       // The compositor will draw directly to the SoftwareOutputDevice which
       // then calls OnPaint.
@@ -649,16 +640,25 @@ void OffScreenRenderWidgetHostView::CopyFromCompositingSurface(
     const gfx::Size& dst_size,
     const content::ReadbackRequestCallback& callback,
     const SkColorType preferred_color_type) {
+  ++pending_readbacks_;
+  UpdateTiledPainting();
   GetDelegatedFrameHost()->CopyFromCompositingSurface(
-    src_subrect, dst_size, callback, preferred_color_type);
+    src_subrect, dst_size,
+    base::Bind(&OffScreenRenderWidgetHostView::OnCopyFromCompositingSurfaceDone,
+               weak_ptr_factory_.GetWeakPtr(), callback),
+    preferred_color_type);
 }
 
 void OffScreenRenderWidgetHostView::CopyFromCompositingSurfaceToVideoFrame(
     const gfx::Rect& src_subrect,
     const scoped_refptr<media::VideoFrame>& target,
     const base::Callback<void(const gfx::Rect&, bool)>& callback) {
+  ++pending_readbacks_;
+  UpdateTiledPainting();
   GetDelegatedFrameHost()->CopyFromCompositingSurfaceToVideoFrame(
-    src_subrect, target, callback);
+    src_subrect, target,
+    base::Bind(&OffScreenRenderWidgetHostView::OnCopyToVideoFrameDone,
+               weak_ptr_factory_.GetWeakPtr(), callback));
 }
 
 bool OffScreenRenderWidgetHostView::CanCopyToVideoFrame() const {
@@ -667,10 +667,14 @@ bool OffScreenRenderWidgetHostView::CanCopyToVideoFrame() const {
 
 void OffScreenRenderWidgetHostView::BeginFrameSubscription(
   std::unique_ptr<content::RenderWidgetHostViewFrameSubscriber> subscriber) {
+  has_frame_subscriber_ = true;
+  UpdateTiledPainting();
   GetDelegatedFrameHost()->BeginFrameSubscription(std::move(subscriber));
 }
 
 void OffScreenRenderWidgetHostView::EndFrameSubscription() {
+  has_frame_subscriber_ = false;
+  UpdateTiledPainting();
   GetDelegatedFrameHost()->EndFrameSubscription();
 }
 
@@ -783,6 +787,42 @@ void OffScreenRenderWidgetHostView::SetBeginFrameSource(
     cc::BeginFrameSource* source) {
 }
 
+void OffScreenRenderWidgetHostView::UpdateTiledPainting() {
+  if (!tiled_ || !software_output_device_)
+    return;
+
+  static_cast<OffScreenTiledOutputDevice*>(software_output_device_)->SetTiled(
+      pending_readbacks_ == 0 && !has_frame_subscriber_ &&
+      !has_background_filters_);
+}
+
+// static
+void OffScreenRenderWidgetHostView::OnCopyFromCompositingSurfaceDone(
+    base::WeakPtr<OffScreenRenderWidgetHostView> view,
+    const content::ReadbackRequestCallback& callback,
+    const SkBitmap& bitmap,
+    content::ReadbackResponse response) {
+  if (view)
+    view->OnReadbackDone();
+  callback.Run(bitmap, response);
+}
+
+// static
+void OffScreenRenderWidgetHostView::OnCopyToVideoFrameDone(
+    base::WeakPtr<OffScreenRenderWidgetHostView> view,
+    const base::Callback<void(const gfx::Rect&, bool)>& callback,
+    const gfx::Rect& region,
+    bool success) {
+  if (view)
+    view->OnReadbackDone();
+  callback.Run(region, success);
+}
+
+void OffScreenRenderWidgetHostView::OnReadbackDone() {
+  --pending_readbacks_;
+  UpdateTiledPainting();
+}
+
 std::unique_ptr<cc::SoftwareOutputDevice>
   OffScreenRenderWidgetHostView::CreateSoftwareOutputDevice(
     ui::Compositor* compositor) {
@@ -790,10 +830,15 @@ std::unique_ptr<cc::SoftwareOutputDevice>
   DCHECK(!copy_frame_generator_);
   DCHECK(!software_output_device_);
 
-  software_output_device_ = new OffScreenOutputDevice(
-      transparent_,
+  OnPaintCallback callback =
       base::Bind(&OffScreenRenderWidgetHostView::OnPaint,
-                 weak_ptr_factory_.GetWeakPtr()));
+                 weak_ptr_factory_.GetWeakPtr());
+  if (tiled_)
+    software_output_device_ =
+        new OffScreenTiledOutputDevice(transparent_, callback);
+  else
+    software_output_device_ = new OffScreenOutputDevice(transparent_, callback);
+  UpdateTiledPainting();
   return base::WrapUnique(software_output_device_);
 }
 
@@ -817,7 +862,7 @@ bool OffScreenRenderWidgetHostView::IsAutoResizeEnabled() const {
 void OffScreenRenderWidgetHostView::OnSetNeedsBeginFrames(bool enabled) {
   SetupFrameRate(false);
 
-  begin_frame_timer_->SetActive(enabled);
+  OffScreenFrameScheduler::GetInstance()->SetActive(this, enabled);
 
   if (software_output_device_) {
     software_output_device_->SetActive(enabled && painting_);
@@ -827,7 +872,10 @@ void OffScreenRenderWidgetHostView::OnSetNeedsBeginFrames(bool enabled) {
 void OffScreenRenderWidgetHostView::OnPaint(
     const gfx::Rect& damage_rect, const SkBitmap& bitmap) {
   TRACE_EVENT0("electron", "OffScreenRenderWidgetHostView::OnPaint");
+  base::TimeTicks start_time = base::TimeTicks::Now();
   callback_.Run(damage_rect, bitmap);
+  OffScreenFrameScheduler::GetInstance()->DidPaint(
+      this, base::TimeTicks::Now() - start_time);
 }
 
 void OffScreenRenderWidgetHostView::SetPainting(bool painting) {
@@ -857,6 +905,23 @@ int OffScreenRenderWidgetHostView::GetFrameRate() const {
   return frame_rate_;
 }
 
+void OffScreenRenderWidgetHostView::SetFramePriority(int priority) {
+  frame_priority_ = priority;
+
+  SetupFrameRate(false);
+  OffScreenFrameScheduler::GetInstance()->SetPriority(this, frame_priority_);
+}
+
+int OffScreenRenderWidgetHostView::GetFramePriority() const {
+  return frame_priority_;
+}
+
+void OffScreenRenderWidgetHostView::SetFrameBudget(int budget_ms) {
+  SetupFrameRate(false);
+  OffScreenFrameScheduler::GetInstance()->SetClientFrameBudget(
+      this, base::TimeDelta::FromMilliseconds(std::max(budget_ms, 0)));
+}
+
 #if !defined(OS_MACOSX)
 ui::Compositor* OffScreenRenderWidgetHostView::GetCompositor() const {
   return compositor_.get();
@@ -886,14 +951,13 @@ void OffScreenRenderWidgetHostView::SetupFrameRate(bool force) {
         frame_rate_threshold_ms_);
   }
 
-  if (begin_frame_timer_.get()) {
-    begin_frame_timer_->SetFrameRateThresholdMs(frame_rate_threshold_ms_);
-  } else {
-    begin_frame_timer_.reset(new AtomBeginFrameTimer(
-        frame_rate_threshold_ms_,
-        base::Bind(&OffScreenRenderWidgetHostView::OnBeginFrameTimerTick,
-                   weak_ptr_factory_.GetWeakPtr())));
-  }
+  auto* scheduler = OffScreenFrameScheduler::GetInstance();
+  const base::TimeDelta interval =
+      base::TimeDelta::FromMilliseconds(frame_rate_threshold_ms_);
+  if (scheduler->HasClient(this))
+    scheduler->SetInterval(this, interval);
+  else
+    scheduler->AddClient(this, interval);
 }
 
 void OffScreenRenderWidgetHostView::Invalidate() {
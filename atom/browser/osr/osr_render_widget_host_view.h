@@ -14,6 +14,7 @@
 
 #include "atom/browser/native_window.h"
 #include "atom/browser/native_window_observer.h"
+#include "atom/browser/osr/osr_frame_scheduler.h"
 #include "atom/browser/osr/osr_output_device.h"
 #include "base/process/kill.h"
 #include "base/threading/thread.h"
@@ -52,7 +53,6 @@ class NSWindow;
 namespace atom {
 
 class AtomCopyFrameGenerator;
-class AtomBeginFrameTimer;
 
 #if defined(OS_MACOSX)
 class MacHelper;
@@ -62,9 +62,11 @@ class OffScreenRenderWidgetHostView
     : public content::RenderWidgetHostViewBase,
       public ui::CompositorDelegate,
       public content::DelegatedFrameHostClient,
-      public NativeWindowObserver {
+      public NativeWindowObserver,
+      public OffScreenFrameScheduler::Client {
  public:
   OffScreenRenderWidgetHostView(bool transparent,
+                                bool tiled,
                                 const OnPaintCallback& callback,
                                 content::RenderWidgetHost* render_widget_host,
                                 NativeWindow* native_window);
@@ -178,7 +180,10 @@ class OffScreenRenderWidgetHostView
   void OnWindowResize() override;
   void OnWindowClosed() override;
 
-  void OnBeginFrameTimerTick();
+  // OffScreenFrameScheduler::Client:
+  void OnBeginFrame(base::TimeTicks frame_time,
+                    base::TimeDelta interval) override;
+
   void SendBeginFrame(base::TimeTicks frame_time,
                       base::TimeDelta vsync_period);
 
@@ -195,6 +200,10 @@ class OffScreenRenderWidgetHostView
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
 
+  void SetFramePriority(int priority);
+  int GetFramePriority() const;
+  void SetFrameBudget(int budget_ms);
+
   ui::Compositor* GetCompositor() const;
   ui::Layer* GetRootLayer() const;
   content::DelegatedFrameHost* GetDelegatedFrameHost() const;
@@ -209,16 +218,38 @@ class OffScreenRenderWidgetHostView
   void SetupFrameRate(bool force);
   void ResizeRootLayer();
 
+  // Paints into the bitmap directly instead of in tiles while the frames are
+  // read back.
+  void UpdateTiledPainting();
+  static void OnCopyFromCompositingSurfaceDone(
+      base::WeakPtr<OffScreenRenderWidgetHostView> view,
+      const content::ReadbackRequestCallback& callback,
+      const SkBitmap& bitmap,
+      content::ReadbackResponse response);
+  static void OnCopyToVideoFrameDone(
+      base::WeakPtr<OffScreenRenderWidgetHostView> view,
+      const base::Callback<void(const gfx::Rect&, bool)>& callback,
+      const gfx::Rect& region,
+      bool success);
+  void OnReadbackDone();
+
   // Weak ptrs.
   content::RenderWidgetHostImpl* render_widget_host_;
   NativeWindow* native_window_;
   OffScreenOutputDevice* software_output_device_;
 
   const bool transparent_;
+  const bool tiled_;
   OnPaintCallback callback_;
 
+  // The reasons to not paint in tiles, see UpdateTiledPainting.
+  int pending_readbacks_;
+  bool has_frame_subscriber_;
+  bool has_background_filters_;
+
   int frame_rate_;
   int frame_rate_threshold_ms_;
+  int frame_priority_;
 
   base::Time last_time_;
 
@@ -233,7 +264,6 @@ class OffScreenRenderWidgetHostView
   std::unique_ptr<content::DelegatedFrameHost> delegated_frame_host_;
 
   std::unique_ptr<AtomCopyFrameGenerator> copy_frame_generator_;
-  std::unique_ptr<AtomBeginFrameTimer> begin_frame_timer_;
 
 #if defined(OS_MACOSX)
   CALayer* background_layer_;
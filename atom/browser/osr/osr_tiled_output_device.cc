@@ -0,0 +1,173 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/osr/osr_tiled_output_device.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/atomic_ref_count.h"
+#include "base/atomic_sequence_num.h"
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
+#include "base/trace_event/trace_event.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "ui/gfx/skia_util.h"
+
+namespace atom {
+
+namespace {
+
+// Size of the square tiles the viewport is split into, in pixels.
+const int kTileSize = 256;
+
+// Plays back a recorded frame into a list of tiles of the same bitmap. Every
+// participating thread pulls the next tile from a shared counter, so the tiles
+// are spread over however many threads actually get to run.
+class TileRasterJob : public base::RefCountedThreadSafe<TileRasterJob> {
+ public:
+  TileRasterJob(sk_sp<SkPicture> picture,
+                const SkBitmap& bitmap,
+                const std::vector<gfx::Rect>& tiles)
+      : picture_(std::move(picture)),
+        bitmap_(bitmap),
+        tiles_(tiles),
+        pending_tiles_(static_cast<int>(tiles.size())),
+        done_(base::WaitableEvent::ResetPolicy::MANUAL,
+              base::WaitableEvent::InitialState::NOT_SIGNALED) {
+  }
+
+  // Rasterizes tiles until there is none left, can be called on any thread.
+  void Run() {
+    while (true) {
+      size_t index = static_cast<size_t>(next_tile_.GetNext());
+      if (index >= tiles_.size())
+        return;
+
+      RasterizeTile(tiles_[index]);
+
+      if (!base::AtomicRefCountDec(&pending_tiles_))
+        done_.Signal();
+    }
+  }
+
+  // Blocks until every tile has been rasterized.
+  void Wait() {
+    done_.Wait();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<TileRasterJob>;
+
+  ~TileRasterJob() {}
+
+  void RasterizeTile(const gfx::Rect& tile) {
+    TRACE_EVENT0("electron", "TileRasterJob::RasterizeTile");
+    // The tiles never overlap, so each thread writes to its own pixels of the
+    // shared bitmap.
+    SkCanvas canvas(bitmap_);
+    canvas.clipRect(gfx::RectToSkRect(tile));
+    canvas.drawPicture(picture_.get());
+  }
+
+  const sk_sp<SkPicture> picture_;
+  const SkBitmap bitmap_;
+  const std::vector<gfx::Rect> tiles_;
+
+  base::AtomicSequenceNumber next_tile_;
+  base::AtomicRefCount pending_tiles_;
+  base::WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(TileRasterJob);
+};
+
+}  // namespace
+
+OffScreenTiledOutputDevice::OffScreenTiledOutputDevice(
+    bool transparent, const OnPaintCallback& callback)
+    : OffScreenOutputDevice(transparent, callback),
+      raster_threads_(std::max(1, base::SysInfo::NumberOfProcessors() - 1)),
+      tiled_(true),
+      recording_(false) {
+}
+
+OffScreenTiledOutputDevice::~OffScreenTiledOutputDevice() {
+}
+
+SkCanvas* OffScreenTiledOutputDevice::BeginPaint(const gfx::Rect& damage_rect) {
+  // Let the parent class track the damage, the frame itself is recorded.
+  SkCanvas* canvas = OffScreenOutputDevice::BeginPaint(damage_rect);
+
+  recording_ = tiled_;
+  if (!recording_)
+    return canvas;
+
+  SkRTreeFactory factory;
+  return recorder_.beginRecording(
+      SkRect::MakeIWH(viewport_pixel_size_.width(),
+                      viewport_pixel_size_.height()),
+      &factory);
+}
+
+void OffScreenTiledOutputDevice::EndPaint() {
+  DCHECK(bitmap());
+
+  if (!recording_) {
+    OffScreenOutputDevice::EndPaint();
+    return;
+  }
+  recording_ = false;
+
+  sk_sp<SkPicture> picture = recorder_.finishRecordingAsPicture();
+  std::vector<gfx::Rect> tiles = GetDamagedTiles(damage_rect_);
+
+  if (!tiles.empty()) {
+    TRACE_EVENT1("electron", "OffScreenTiledOutputDevice::EndPaint",
+                 "tiles", tiles.size());
+    SkAutoLockPixels bitmap_pixels_lock(*bitmap());
+
+    scoped_refptr<TileRasterJob> job(
+        new TileRasterJob(std::move(picture), *bitmap(), tiles));
+    int workers =
+        std::min(raster_threads_, static_cast<int>(tiles.size()) - 1);
+    for (int i = 0; i < workers; ++i) {
+      base::WorkerPool::PostTask(
+          FROM_HERE, base::Bind(&TileRasterJob::Run, job), false);
+    }
+
+    // The current thread takes tiles too, so a busy pool can not stall us.
+    job->Run();
+    job->Wait();
+  }
+
+  OffScreenOutputDevice::EndPaint();
+}
+
+std::vector<gfx::Rect> OffScreenTiledOutputDevice::GetDamagedTiles(
+    const gfx::Rect& damage_rect) const {
+  gfx::Rect viewport(viewport_pixel_size_);
+  gfx::Rect rect = damage_rect;
+  rect.Intersect(viewport);
+
+  std::vector<gfx::Rect> tiles;
+  if (rect.IsEmpty())
+    return tiles;
+
+  int first_x = rect.x() / kTileSize * kTileSize;
+  int first_y = rect.y() / kTileSize * kTileSize;
+  for (int y = first_y; y < rect.bottom(); y += kTileSize) {
+    for (int x = first_x; x < rect.right(); x += kTileSize) {
+      gfx::Rect tile(x, y, kTileSize, kTileSize);
+      tile.Intersect(rect);
+      tiles.push_back(tile);
+    }
+  }
+  return tiles;
+}
+
+}  // namespace atom
@@ -0,0 +1,51 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_OSR_OSR_TILED_OUTPUT_DEVICE_H_
+#define ATOM_BROWSER_OSR_OSR_TILED_OUTPUT_DEVICE_H_
+
+#include <vector>
+
+#include "atom/browser/osr/osr_output_device.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace atom {
+
+// Software output device that records the compositor's draw calls into a
+// picture and then plays it back into the damaged tiles of the shared bitmap
+// in parallel on the worker pool.
+//
+// The recording canvas has no pixels, so frames that read them back, e.g. for
+// copy requests or backdrop filters, have to be painted into the bitmap
+// directly, see SetTiled.
+class OffScreenTiledOutputDevice : public OffScreenOutputDevice {
+ public:
+  OffScreenTiledOutputDevice(bool transparent, const OnPaintCallback& callback);
+  ~OffScreenTiledOutputDevice();
+
+  // cc::SoftwareOutputDevice:
+  SkCanvas* BeginPaint(const gfx::Rect& damage_rect) override;
+  void EndPaint() override;
+
+  // Whether the next frames are recorded and rasterized in tiles, or painted
+  // directly into the bitmap.
+  void SetTiled(bool tiled) { tiled_ = tiled; }
+
+ private:
+  // Splits |damage_rect| into the tiles of the viewport that it touches.
+  std::vector<gfx::Rect> GetDamagedTiles(const gfx::Rect& damage_rect) const;
+
+  SkPictureRecorder recorder_;
+  int raster_threads_;
+
+  bool tiled_;
+  // Whether the frame being painted is recorded.
+  bool recording_;
+
+  DISALLOW_COPY_AND_ASSIGN(OffScreenTiledOutputDevice);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_OSR_OSR_TILED_OUTPUT_DEVICE_H_
@@ -7,8 +7,9 @@
 namespace atom {
 
 OffScreenWebContentsView::OffScreenWebContentsView(
-    bool transparent, const OnPaintCallback& callback)
+    bool transparent, bool tiled, const OnPaintCallback& callback)
     : transparent_(transparent),
+      tiled_(tiled),
       callback_(callback),
       web_contents_(nullptr) {
 #if defined(OS_MACOSX)
@@ -77,7 +78,7 @@ content::RenderWidgetHostViewBase*
     content::RenderWidgetHost* render_widget_host, bool is_guest_view_hack) {
   auto relay = NativeWindowRelay::FromWebContents(web_contents_);
   view_ = new OffScreenRenderWidgetHostView(
-      transparent_, callback_, render_widget_host, relay->window.get());
+      transparent_, tiled_, callback_, render_widget_host, relay->window.get());
   return view_;
 }
 
@@ -86,7 +87,7 @@ content::RenderWidgetHostViewBase*
     content::RenderWidgetHost* render_widget_host) {
   auto relay = NativeWindowRelay::FromWebContents(web_contents_);
   view_ = new OffScreenRenderWidgetHostView(
-      transparent_, callback_, render_widget_host, relay->window.get());
+      transparent_, tiled_, callback_, render_widget_host, relay->window.get());
   return view_;
 }
 
@@ -23,7 +23,9 @@ namespace atom {
 class OffScreenWebContentsView : public content::WebContentsView,
                                  public content::RenderViewHostDelegateView {
  public:
-  OffScreenWebContentsView(bool transparent, const OnPaintCallback& callback);
+  OffScreenWebContentsView(bool transparent,
+                           bool tiled,
+                           const OnPaintCallback& callback);
   ~OffScreenWebContentsView();
 
   void SetWebContents(content::WebContents*);
@@ -75,6 +77,7 @@ class OffScreenWebContentsView : public content::WebContentsView,
 #endif
 
   const bool transparent_;
+  const bool tiled_;
   OnPaintCallback callback_;
 
   // Weak refs.
@@ -4,10 +4,12 @@
 
 #include "atom/common/api/atom_api_native_image.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "atom/common/asar/asar_util.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -16,6 +18,7 @@
 #include "base/files/file_util.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
+#include "base/threading/worker_pool.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
@@ -76,10 +79,7 @@ float GetScaleFactorFromPath(const base::FilePath& path) {
   return 1.0f;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
-                     const unsigned char* data,
-                     size_t size,
-                     double scale_factor) {
+std::unique_ptr<SkBitmap> DecodeImage(const unsigned char* data, size_t size) {
   std::unique_ptr<SkBitmap> decoded(new SkBitmap());
 
   // Try PNG first.
@@ -87,6 +87,14 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
     // Try JPEG.
     decoded = gfx::JPEGCodec::Decode(data, size);
 
+  return decoded;
+}
+
+bool AddImageSkiaRep(gfx::ImageSkia* image,
+                     const unsigned char* data,
+                     size_t size,
+                     double scale_factor) {
+  std::unique_ptr<SkBitmap> decoded = DecodeImage(data, size);
   if (!decoded)
     return false;
 
@@ -175,7 +183,97 @@ bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon) {
 }
 #endif
 
-void Noop(char*, void*) {
+// Drops the reference to the pixels of a Buffer created by getBitmap.
+void ReleaseBitmap(char*, void* hint) {
+  delete static_cast<SkBitmap*>(hint);
+}
+
+void FreeEncodedImage(char*, void* hint) {
+  delete static_cast<std::vector<unsigned char>*>(hint);
+}
+
+// The JavaScript side of an asynchronous call, which is only touched by the
+// reply on the calling thread.
+struct AsyncCall {
+  AsyncCall(v8::Isolate* isolate, const NativeImage::AsyncCallback& callback)
+      : isolate(isolate),
+        context(isolate, isolate->GetCurrentContext()),
+        callback(callback) {}
+
+  v8::Isolate* isolate;
+  v8::Global<v8::Context> context;
+  NativeImage::AsyncCallback callback;
+  // Keeps the buffer read by the worker alive.
+  v8::Global<v8::Value> input;
+};
+
+// Runs |task| in the worker pool and then |reply| on the current thread.
+void PostToWorkerPool(const base::Closure& task, const base::Closure& reply) {
+  base::WorkerPool::PostTaskAndReply(FROM_HERE, task, reply, true);
+}
+
+void EncodePNG(const SkBitmap& bitmap, std::vector<unsigned char>* output) {
+  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, output);
+}
+
+void OnPNGEncoded(std::unique_ptr<AsyncCall> call,
+                  std::unique_ptr<std::vector<unsigned char>> png) {
+  v8::Isolate* isolate = call->isolate;
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(call->context.Get(isolate));
+
+  v8::Local<v8::Value> buffer;
+  if (png->empty()) {
+    buffer = node::Buffer::New(isolate, 0).ToLocalChecked();
+  } else {
+    // The Buffer takes over the encoded data.
+    char* data = reinterpret_cast<char*>(png->data());
+    size_t size = png->size();
+    buffer = node::Buffer::New(isolate, data, size, &FreeEncodedImage,
+                               png.release()).ToLocalChecked();
+  }
+  call->callback.Run(buffer);
+}
+
+void ResizeImageReps(const std::vector<gfx::ImageSkiaRep>& reps,
+                     skia::ImageOperations::ResizeMethod method,
+                     const gfx::Size& size,
+                     std::vector<gfx::ImageSkiaRep>* resized) {
+  for (const auto& rep : reps) {
+    gfx::Size pixel_size = gfx::ScaleToCeiledSize(size, rep.scale());
+    if (pixel_size.IsEmpty())
+      continue;
+    resized->push_back(gfx::ImageSkiaRep(
+        skia::ImageOperations::Resize(rep.sk_bitmap(), method,
+                                      pixel_size.width(),
+                                      pixel_size.height()),
+        rep.scale()));
+  }
+}
+
+void OnImageRepsReady(std::unique_ptr<AsyncCall> call,
+                      std::unique_ptr<std::vector<gfx::ImageSkiaRep>> reps) {
+  v8::Isolate* isolate = call->isolate;
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(call->context.Get(isolate));
+
+  gfx::ImageSkia image_skia;
+  for (const auto& rep : *reps)
+    image_skia.AddRepresentation(rep);
+  call->callback.Run(
+      NativeImage::Create(isolate, gfx::Image(image_skia)).ToV8());
+}
+
+void DecodeImageRep(const char* data,
+                    size_t size,
+                    double scale_factor,
+                    std::vector<gfx::ImageSkiaRep>* reps) {
+  std::unique_ptr<SkBitmap> decoded =
+      DecodeImage(reinterpret_cast<const unsigned char*>(data), size);
+  if (decoded)
+    reps->push_back(gfx::ImageSkiaRep(*decoded, scale_factor));
 }
 
 }  // namespace
@@ -226,6 +324,26 @@ v8::Local<v8::Value> NativeImage::ToPNG(v8::Isolate* isolate) {
                             static_cast<size_t>(png->size())).ToLocalChecked();
 }
 
+void NativeImage::ToPNGAsync(v8::Isolate* isolate,
+                             const AsyncCallback& callback) {
+  // Images created from PNG keep their encoded data.
+  if (image_.IsEmpty() || image_.HasRepresentation(gfx::Image::kImageRepPNG)) {
+    callback.Run(ToPNG(isolate));
+    return;
+  }
+
+  // The bitmap shares its pixels with the image, they are only read by the
+  // worker.
+  SkBitmap bitmap = image_.AsImageSkia().GetRepresentation(1.0f).sk_bitmap();
+  std::unique_ptr<std::vector<unsigned char>> png(
+      new std::vector<unsigned char>);
+  std::vector<unsigned char>* output = png.get();
+  std::unique_ptr<AsyncCall> call(new AsyncCall(isolate, callback));
+  PostToWorkerPool(
+      base::Bind(&EncodePNG, bitmap, base::Unretained(output)),
+      base::Bind(&OnPNGEncoded, base::Passed(&call), base::Passed(&png)));
+}
+
 v8::Local<v8::Value> NativeImage::ToBitmap(v8::Isolate* isolate) {
   const SkBitmap* bitmap = image_.ToSkBitmap();
   SkPixelRef* ref = bitmap->pixelRef();
@@ -253,13 +371,19 @@ std::string NativeImage::ToDataURL() {
 }
 
 v8::Local<v8::Value> NativeImage::GetBitmap(v8::Isolate* isolate) {
-  const SkBitmap* bitmap = image_.ToSkBitmap();
-  SkPixelRef* ref = bitmap->pixelRef();
+  // The copied bitmap shares and keeps locked the pixels of the image, so the
+  // Buffer stays valid after the image is gone.
+  SkBitmap* bitmap = new SkBitmap(*image_.ToSkBitmap());
+  bitmap->lockPixels();
+  if (!bitmap->getPixels()) {
+    delete bitmap;
+    return node::Buffer::New(isolate, 0).ToLocalChecked();
+  }
   return node::Buffer::New(isolate,
-                           reinterpret_cast<char*>(ref->pixels()),
+                           reinterpret_cast<char*>(bitmap->getPixels()),
                            bitmap->getSafeSize(),
-                           &Noop,
-                           nullptr).ToLocalChecked();
+                           &ReleaseBitmap,
+                           bitmap).ToLocalChecked();
 }
 
 v8::Local<v8::Value> NativeImage::GetNativeHandle(v8::Isolate* isolate,
@@ -292,8 +416,10 @@ float NativeImage::GetAspectRatio() {
     return static_cast<float>(size.width()) / static_cast<float>(size.height());
 }
 
-mate::Handle<NativeImage> NativeImage::Resize(
-    v8::Isolate* isolate, const base::DictionaryValue& options) {
+void NativeImage::GetResizeParameters(
+    const base::DictionaryValue& options,
+    gfx::Size* resize_size,
+    skia::ImageOperations::ResizeMethod* resize_method) {
   gfx::Size size = GetSize();
   int width = size.width();
   int height = size.height();
@@ -320,12 +446,49 @@ mate::Handle<NativeImage> NativeImage::Resize(
   else if (quality == "better")
     method = skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
 
+  *resize_size = size;
+  *resize_method = method;
+}
+
+mate::Handle<NativeImage> NativeImage::Resize(
+    v8::Isolate* isolate, const base::DictionaryValue& options) {
+  gfx::Size size;
+  skia::ImageOperations::ResizeMethod method;
+  GetResizeParameters(options, &size, &method);
+
   gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
       image_.AsImageSkia(), method, size);
   return mate::CreateHandle(isolate,
                             new NativeImage(isolate, gfx::Image(resized)));
 }
 
+void NativeImage::ResizeAsync(v8::Isolate* isolate,
+                              const base::DictionaryValue& options,
+                              const AsyncCallback& callback) {
+  gfx::Size size;
+  skia::ImageOperations::ResizeMethod method;
+  GetResizeParameters(options, &size, &method);
+
+  // Unlike resize(), which resizes each scale factor lazily when it is used,
+  // all representations of the image are resized at once by the worker.
+  std::vector<gfx::ImageSkiaRep> reps;
+  if (!image_.IsEmpty()) {
+    reps = image_.AsImageSkia().image_reps();
+    if (reps.empty())
+      reps.push_back(image_.AsImageSkia().GetRepresentation(1.0f));
+  }
+
+  std::unique_ptr<std::vector<gfx::ImageSkiaRep>> resized(
+      new std::vector<gfx::ImageSkiaRep>);
+  std::vector<gfx::ImageSkiaRep>* output = resized.get();
+  std::unique_ptr<AsyncCall> call(new AsyncCall(isolate, callback));
+  PostToWorkerPool(
+      base::Bind(&ResizeImageReps, reps, method, size,
+                 base::Unretained(output)),
+      base::Bind(&OnImageRepsReady, base::Passed(&call),
+                 base::Passed(&resized)));
+}
+
 mate::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
                                             const gfx::Rect& rect) {
   gfx::ImageSkia cropped = gfx::ImageSkiaOperations::ExtractSubset(
@@ -406,6 +569,60 @@ mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
   return Create(args->isolate(), gfx::Image(image_skia));
 }
 
+// static
+mate::Handle<NativeImage> NativeImage::CreateFromBitmap(
+    mate::Arguments* args, v8::Local<v8::Value> buffer) {
+  mate::Dictionary options;
+  int width = 0, height = 0;
+  double scale_factor = 1.;
+  if (!node::Buffer::HasInstance(buffer) || !args->GetNext(&options) ||
+      !options.Get("width", &width) || !options.Get("height", &height)) {
+    args->ThrowError("Must pass a Buffer and its width and height");
+    return CreateEmpty(args->isolate());
+  }
+  options.Get("scaleFactor", &scale_factor);
+
+  SkBitmap bitmap;
+  if (width <= 0 || height <= 0 ||
+      !bitmap.tryAllocN32Pixels(width, height) ||
+      node::Buffer::Length(buffer) < bitmap.getSafeSize()) {
+    args->ThrowError("Invalid bitmap size");
+    return CreateEmpty(args->isolate());
+  }
+
+  SkAutoLockPixels lock(bitmap);
+  memcpy(bitmap.getPixels(), node::Buffer::Data(buffer),
+         bitmap.getSafeSize());
+  gfx::ImageSkia image_skia;
+  image_skia.AddRepresentation(gfx::ImageSkiaRep(bitmap, scale_factor));
+  return Create(args->isolate(), gfx::Image(image_skia));
+}
+
+// static
+void NativeImage::CreateFromBufferAsync(mate::Arguments* args) {
+  // createFromBufferAsync(buffer, scaleFactor, callback)
+  v8::Local<v8::Value> buffer;
+  double scale_factor = 1.;
+  AsyncCallback callback;
+  if (!args->GetNext(&buffer) || !node::Buffer::HasInstance(buffer) ||
+      !args->GetNext(&scale_factor) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+
+  std::unique_ptr<std::vector<gfx::ImageSkiaRep>> reps(
+      new std::vector<gfx::ImageSkiaRep>);
+  std::vector<gfx::ImageSkiaRep>* output = reps.get();
+  std::unique_ptr<AsyncCall> call(new AsyncCall(args->isolate(), callback));
+  // The worker decodes the data of the Buffer in place.
+  call->input.Reset(args->isolate(), buffer);
+  PostToWorkerPool(
+      base::Bind(&DecodeImageRep, node::Buffer::Data(buffer),
+                 node::Buffer::Length(buffer), scale_factor,
+                 base::Unretained(output)),
+      base::Bind(&OnImageRepsReady, base::Passed(&call), base::Passed(&reps)));
+}
+
 // static
 mate::Handle<NativeImage> NativeImage::CreateFromDataURL(
     v8::Isolate* isolate, const GURL& url) {
@@ -426,6 +643,7 @@ void NativeImage::BuildPrototype(
   prototype->SetClassName(mate::StringToV8(isolate, "NativeImage"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("toPNG", &NativeImage::ToPNG)
+      .SetMethod("_toPNGAsync", &NativeImage::ToPNGAsync)
       .SetMethod("toJPEG", &NativeImage::ToJPEG)
       .SetMethod("toBitmap", &NativeImage::ToBitmap)
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
@@ -436,6 +654,7 @@ void NativeImage::BuildPrototype(
       .SetMethod("setTemplateImage", &NativeImage::SetTemplateImage)
       .SetMethod("isTemplateImage", &NativeImage::IsTemplateImage)
       .SetMethod("resize", &NativeImage::Resize)
+      .SetMethod("_resizeAsync", &NativeImage::ResizeAsync)
       .SetMethod("crop", &NativeImage::Crop)
       .SetMethod("getAspectRatio", &NativeImage::GetAspectRatio)
       // TODO(kevinsawicki): Remove in 2.0, deprecate before then with warnings
@@ -485,6 +704,9 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("createEmpty", &atom::api::NativeImage::CreateEmpty);
   dict.SetMethod("createFromPath", &atom::api::NativeImage::CreateFromPath);
   dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
+  dict.SetMethod("createFromBitmap", &atom::api::NativeImage::CreateFromBitmap);
+  dict.SetMethod("_createFromBufferAsync",
+                 &atom::api::NativeImage::CreateFromBufferAsync);
   dict.SetMethod("createFromDataURL",
                  &atom::api::NativeImage::CreateFromDataURL);
 }
@@ -11,6 +11,7 @@
 #include "base/values.h"
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
+#include "skia/ext/image_operations.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/image/image.h"
 
@@ -39,6 +40,9 @@ namespace api {
 
 class NativeImage : public mate::Wrappable<NativeImage> {
  public:
+  // Receives the result of an asynchronous method.
+  using AsyncCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
   static mate::Handle<NativeImage> CreateEmpty(v8::Isolate* isolate);
   static mate::Handle<NativeImage> Create(
       v8::Isolate* isolate, const gfx::Image& image);
@@ -50,6 +54,9 @@ class NativeImage : public mate::Wrappable<NativeImage> {
       v8::Isolate* isolate, const base::FilePath& path);
   static mate::Handle<NativeImage> CreateFromBuffer(
       mate::Arguments* args, v8::Local<v8::Value> buffer);
+  static mate::Handle<NativeImage> CreateFromBitmap(
+      mate::Arguments* args, v8::Local<v8::Value> buffer);
+  static void CreateFromBufferAsync(mate::Arguments* args);
   static mate::Handle<NativeImage> CreateFromDataURL(
       v8::Isolate* isolate, const GURL& url);
 
@@ -71,6 +78,7 @@ class NativeImage : public mate::Wrappable<NativeImage> {
 
  private:
   v8::Local<v8::Value> ToPNG(v8::Isolate* isolate);
+  void ToPNGAsync(v8::Isolate* isolate, const AsyncCallback& callback);
   v8::Local<v8::Value> ToJPEG(v8::Isolate* isolate, int quality);
   v8::Local<v8::Value> ToBitmap(v8::Isolate* isolate);
   v8::Local<v8::Value> GetBitmap(v8::Isolate* isolate);
@@ -79,6 +87,12 @@ class NativeImage : public mate::Wrappable<NativeImage> {
     mate::Arguments* args);
   mate::Handle<NativeImage> Resize(v8::Isolate* isolate,
                                    const base::DictionaryValue& options);
+  void ResizeAsync(v8::Isolate* isolate,
+                   const base::DictionaryValue& options,
+                   const AsyncCallback& callback);
+  void GetResizeParameters(const base::DictionaryValue& options,
+                           gfx::Size* size,
+                           skia::ImageOperations::ResizeMethod* method);
   mate::Handle<NativeImage> Crop(v8::Isolate* isolate,
                                  const gfx::Rect& rect);
   std::string ToDataURL();
@@ -6,10 +6,13 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "atom/common/atom_version.h"
 #include "atom/common/chrome_version.h"
+#include "atom/common/event_loop_stats.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/node_includes.h"
 #include "base/logging.h"
@@ -72,6 +75,44 @@ v8::Local<v8::Value> GetSystemMemoryInfo(v8::Isolate* isolate,
   return dict.GetHandle();
 }
 
+mate::Dictionary TimingToDictionary(v8::Isolate* isolate,
+                                    const EventLoopStats::Timing& timing) {
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("count", static_cast<double>(timing.count));
+  dict.Set("totalTime", timing.total.InMillisecondsF());
+  dict.Set("maxTime", timing.max.InMillisecondsF());
+  return dict;
+}
+
+v8::Local<v8::Value> GetEventLoopStats(v8::Isolate* isolate) {
+  EventLoopStats* stats = EventLoopStats::Get();
+  stats->EnableHandlerStats();
+
+  std::vector<v8::Local<v8::Value>> histogram;
+  for (size_t i = 0; i < EventLoopStats::kLagBucketCount; ++i) {
+    mate::Dictionary bucket = mate::Dictionary::CreateEmpty(isolate);
+    if (i < EventLoopStats::kLagBucketCount - 1)
+      bucket.Set("max", EventLoopStats::kLagBucketBoundsMs[i]);
+    else
+      bucket.Set("max", std::numeric_limits<double>::infinity());
+    bucket.Set("count", static_cast<double>(stats->lag_histogram()[i]));
+    histogram.push_back(bucket.GetHandle());
+  }
+
+  mate::Dictionary lag = TimingToDictionary(isolate, stats->loop_lag());
+  lag.Set("histogram", histogram);
+
+  mate::Dictionary handlers = mate::Dictionary::CreateEmpty(isolate);
+  for (const auto& it : stats->handlers())
+    handlers.Set(it.first, TimingToDictionary(isolate, it.second));
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("loopLag", lag);
+  dict.Set("uvRun", TimingToDictionary(isolate, stats->uv_run()));
+  dict.Set("handlers", handlers);
+  return dict.GetHandle();
+}
+
 // Called when there is a fatal error in V8, we just crash the process here so
 // we can get the stack trace.
 void FatalErrorCallback(const char* location, const char* message) {
@@ -100,6 +141,7 @@ void AtomBindings::BindTo(v8::Isolate* isolate,
   dict.SetMethod("log", &Log);
   dict.SetMethod("getProcessMemoryInfo", &GetProcessMemoryInfo);
   dict.SetMethod("getSystemMemoryInfo", &GetSystemMemoryInfo);
+  dict.SetMethod("getEventLoopStats", &GetEventLoopStats);
 #if defined(OS_POSIX)
   dict.SetMethod("setFdLimit", &base::SetFdLimit);
 #endif
@@ -4,17 +4,37 @@
 
 #include "atom/common/api/event_emitter_caller.h"
 
+#include <string.h>
+
+#include <string>
+
 #include "atom/common/api/locker.h"
+#include "atom/common/event_loop_stats.h"
 #include "atom/common/node_includes.h"
 
 namespace mate {
 
 namespace internal {
 
+namespace {
+
+// Name of the handlers run by the call, which is the event name for emit().
+std::string GetHandlerName(const char* method, ValueVector* args) {
+  if (strcmp(method, "emit") == 0 && !args->empty() &&
+      args->front()->IsString())
+    return *v8::String::Utf8Value(args->front());
+  return method;
+}
+
+}  // namespace
+
 v8::Local<v8::Value> CallMethodWithArgs(v8::Isolate* isolate,
                                         v8::Local<v8::Object> obj,
                                         const char* method,
                                         ValueVector* args) {
+  atom::ScopedHandlerTimer handler_timer;
+  if (atom::ScopedHandlerTimer::ShouldStart())
+    handler_timer.Start(GetHandlerName(method, args));
   // Perform microtask checkpoint after running JavaScript.
   v8::MicrotasksScope script_scope(isolate,
                                    v8::MicrotasksScope::kRunMicrotasks);
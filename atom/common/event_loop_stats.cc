@@ -0,0 +1,127 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/event_loop_stats.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/trace_event/trace_event.h"
+
+namespace atom {
+
+namespace {
+
+// Handler names are mostly fixed event names, but IPC channels are chosen by
+// the app, so stop adding names past this limit.
+const size_t kMaxHandlerNames = 1000;
+const char kOtherHandlers[] = "(other)";
+
+EventLoopStats* g_event_loop_stats = nullptr;
+
+// Whether a ScopedHandlerTimer is running.
+bool g_handler_timer_running = false;
+
+void TraceLongTask(const std::string& name, base::TimeDelta duration) {
+  if (duration.InMilliseconds() < EventLoopStats::kLongTaskThresholdMs)
+    return;
+
+  TRACE_EVENT_INSTANT2("electron.longtask", "LongTask",
+                       TRACE_EVENT_SCOPE_THREAD,
+                       "name", TRACE_STR_COPY(name.c_str()),
+                       "ms", duration.InMillisecondsF());
+}
+
+}  // namespace
+
+const int EventLoopStats::kLagBucketBoundsMs[] = {
+  1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024,
+};
+
+EventLoopStats::Timing::Timing() : count(0) {
+}
+
+void EventLoopStats::Timing::Add(base::TimeDelta duration) {
+  ++count;
+  total += duration;
+  max = std::max(max, duration);
+}
+
+// static
+EventLoopStats* EventLoopStats::Get() {
+  if (!g_event_loop_stats)
+    g_event_loop_stats = new EventLoopStats;
+  return g_event_loop_stats;
+}
+
+EventLoopStats::EventLoopStats() : handler_stats_enabled_(false) {
+  std::fill(lag_histogram_, lag_histogram_ + kLagBucketCount, 0);
+}
+
+EventLoopStats::~EventLoopStats() {
+}
+
+void EventLoopStats::RecordLoopLag(base::TimeDelta lag) {
+  loop_lag_.Add(lag);
+
+  size_t bucket = 0;
+  while (bucket < kLagBucketCount - 1 &&
+         lag.InMilliseconds() >= kLagBucketBoundsMs[bucket])
+    ++bucket;
+  ++lag_histogram_[bucket];
+}
+
+void EventLoopStats::RecordUvRun(base::TimeDelta duration) {
+  uv_run_.Add(duration);
+  TraceLongTask("uv_run", duration);
+}
+
+void EventLoopStats::RecordHandler(const std::string& name,
+                                   base::TimeDelta duration) {
+  auto it = handlers_.find(name);
+  if (it == handlers_.end()) {
+    std::string key = name;
+    if (handlers_.size() >= kMaxHandlerNames)
+      key = kOtherHandlers;
+    it = handlers_.insert(std::make_pair(key, Timing())).first;
+  }
+  it->second.Add(duration);
+  TraceLongTask(name, duration);
+}
+
+ScopedHandlerTimer::ScopedHandlerTimer() : started_(false) {
+}
+
+ScopedHandlerTimer::~ScopedHandlerTimer() {
+  if (!started_)
+    return;
+
+  g_handler_timer_running = false;
+  TRACE_EVENT_END0("electron", "EventHandler");
+  EventLoopStats::Get()->RecordHandler(name_,
+                                       base::TimeTicks::Now() - start_time_);
+}
+
+// static
+bool ScopedHandlerTimer::ShouldStart() {
+  if (g_handler_timer_running)
+    return false;
+  if (EventLoopStats::Get()->handler_stats_enabled())
+    return true;
+  bool tracing = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED("electron", &tracing);
+  return tracing;
+}
+
+void ScopedHandlerTimer::Start(const std::string& name) {
+  DCHECK(!started_);
+  started_ = true;
+  g_handler_timer_running = true;
+  name_ = name;
+  start_time_ = base::TimeTicks::Now();
+  TRACE_EVENT_BEGIN1("electron", "EventHandler",
+                     "name", TRACE_STR_COPY(name_.c_str()));
+}
+
+}  // namespace atom
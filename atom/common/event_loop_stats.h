@@ -0,0 +1,101 @@
+// Copyright (c) 2016 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_EVENT_LOOP_STATS_H_
+#define ATOM_COMMON_EVENT_LOOP_STATS_H_
+
+#include <map>
+#include <string>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+
+namespace atom {
+
+// Collects how long the main thread waits for and spends in JavaScript, it
+// must only be used on the thread that runs the uv loop.
+//
+// Tasks taking longer than kLongTaskThresholdMs are also emitted as trace
+// events in the "electron.longtask" category.
+class EventLoopStats {
+ public:
+  // The loop lag histogram has a bucket for each upper bound in
+  // kLagBucketBoundsMs, plus one for everything above the last bound.
+  static const size_t kLagBucketCount = 12;
+  static const int kLagBucketBoundsMs[kLagBucketCount - 1];
+
+  static const int kLongTaskThresholdMs = 50;
+
+  struct Timing {
+    Timing();
+
+    void Add(base::TimeDelta duration);
+
+    int64_t count;
+    base::TimeDelta total;
+    base::TimeDelta max;
+  };
+
+  static EventLoopStats* Get();
+
+  // The time between uv having events and the main thread running them.
+  void RecordLoopLag(base::TimeDelta lag);
+
+  // The time spent in one run of the uv loop.
+  void RecordUvRun(base::TimeDelta duration);
+
+  // The time spent in the JavaScript handlers of |name|.
+  void RecordHandler(const std::string& name, base::TimeDelta duration);
+
+  // Handlers are only timed once their stats have been asked for, so emits
+  // do not pay for it otherwise.
+  void EnableHandlerStats() { handler_stats_enabled_ = true; }
+  bool handler_stats_enabled() const { return handler_stats_enabled_; }
+
+  const Timing& loop_lag() const { return loop_lag_; }
+  const int64_t* lag_histogram() const { return lag_histogram_; }
+  const Timing& uv_run() const { return uv_run_; }
+  const std::map<std::string, Timing>& handlers() const { return handlers_; }
+
+ private:
+  EventLoopStats();
+  ~EventLoopStats();
+
+  Timing loop_lag_;
+  int64_t lag_histogram_[kLagBucketCount];
+  Timing uv_run_;
+  bool handler_stats_enabled_;
+  std::map<std::string, Timing> handlers_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventLoopStats);
+};
+
+// Records the time spent in its scope as a handler of |name| once started.
+//
+// Only the outermost timer is started, so a handler that makes native code
+// call other handlers is counted once, e.g. IPC messages are counted as their
+// channel and not again as the "ipc-message" event.
+class ScopedHandlerTimer {
+ public:
+  ScopedHandlerTimer();
+  ~ScopedHandlerTimer();
+
+  // Whether Start should be called, false when neither the handler stats nor
+  // the "electron" trace category are enabled, or when another timer is
+  // running. Callers check it before building the name.
+  static bool ShouldStart();
+
+  void Start(const std::string& name);
+
+ private:
+  std::string name_;
+  base::TimeTicks start_time_;
+  bool started_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedHandlerTimer);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_EVENT_LOOP_STATS_H_
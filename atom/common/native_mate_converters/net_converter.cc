@@ -119,15 +119,27 @@ namespace atom {
 
 void FillRequestDetails(base::DictionaryValue* details,
                         const net::URLRequest* request) {
-  details->SetString("method", request->method());
-  std::string url;
-  if (!request->url_chain().empty()) url = request->url().spec();
-  details->SetStringWithoutPathExpansion("url", url);
-  details->SetString("referrer", request->referrer());
-  std::unique_ptr<base::ListValue> list(new base::ListValue);
-  GetUploadData(list.get(), request);
-  if (!list->empty())
-    details->Set("uploadData", std::move(list));
+  FillRequestDetails(details, request, kAllRequestDetails);
+}
+
+void FillRequestDetails(base::DictionaryValue* details,
+                        const net::URLRequest* request,
+                        uint32_t fields) {
+  if (fields & kRequestDetailsMethod)
+    details->SetString("method", request->method());
+  if (fields & kRequestDetailsUrl) {
+    std::string url;
+    if (!request->url_chain().empty()) url = request->url().spec();
+    details->SetStringWithoutPathExpansion("url", url);
+  }
+  if (fields & kRequestDetailsReferrer)
+    details->SetString("referrer", request->referrer());
+  if (fields & kRequestDetailsUploadData) {
+    std::unique_ptr<base::ListValue> list(new base::ListValue);
+    GetUploadData(list.get(), request);
+    if (!list->empty())
+      details->Set("uploadData", std::move(list));
+  }
 }
 
 void GetUploadData(base::ListValue* upload_data_list,
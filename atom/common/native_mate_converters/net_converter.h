@@ -51,8 +51,21 @@ struct Converter<net::HttpResponseHeaders*> {
 
 namespace atom {
 
+// Fields of the request set by FillRequestDetails.
+enum RequestDetailsField : uint32_t {
+  kRequestDetailsMethod = 1 << 0,
+  kRequestDetailsUrl = 1 << 1,
+  kRequestDetailsReferrer = 1 << 2,
+  kRequestDetailsUploadData = 1 << 3,
+  kAllRequestDetails = (1 << 4) - 1,
+};
+
 void FillRequestDetails(base::DictionaryValue* details,
                         const net::URLRequest* request);
+// Only sets the fields in |fields|, a bit set of RequestDetailsField.
+void FillRequestDetails(base::DictionaryValue* details,
+                        const net::URLRequest* request,
+                        uint32_t fields);
 
 void GetUploadData(base::ListValue* upload_data_list,
                    const net::URLRequest* request);
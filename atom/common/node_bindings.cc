@@ -10,6 +10,7 @@
 #include "atom/common/api/event_emitter_caller.h"
 #include "atom/common/api/locker.h"
 #include "atom/common/atom_command_line.h"
+#include "atom/common/event_loop_stats.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "base/base_paths.h"
 #include "base/command_line.h"
@@ -109,6 +110,7 @@ NodeBindings::NodeBindings(bool is_browser)
       message_loop_(nullptr),
       uv_loop_(uv_default_loop()),
       embed_closed_(false),
+      embed_thread_started_(false),
       uv_env_(nullptr),
       weak_factory_(this) {
 }
@@ -120,7 +122,8 @@ NodeBindings::~NodeBindings() {
   WakeupEmbedThread();
 
   // Wait for everything to be done.
-  uv_thread_join(&embed_thread_);
+  if (embed_thread_started_)
+    uv_thread_join(&embed_thread_);
 
   // Clear uv.
   uv_sem_destroy(&embed_sem_);
@@ -210,7 +213,10 @@ void NodeBindings::PrepareMessageLoop() {
 
   // Start worker that will interrupt main loop when having uv events.
   uv_sem_init(&embed_sem_, 0);
-  uv_thread_create(&embed_thread_, EmbedThreadRunner, this);
+  if (!WatchBackendFd()) {
+    uv_thread_create(&embed_thread_, EmbedThreadRunner, this);
+    embed_thread_started_ = true;
+  }
 }
 
 void NodeBindings::RunMessageLoop() {
@@ -240,18 +246,36 @@ void NodeBindings::UvRunOnce() {
                                    v8::MicrotasksScope::kRunMicrotasks);
 
   // Deal with uv events.
+  base::TimeTicks start_time = base::TimeTicks::Now();
   int r = uv_run(uv_loop_, UV_RUN_NOWAIT);
+  EventLoopStats::Get()->RecordUvRun(base::TimeTicks::Now() - start_time);
   if (r == 0)
     message_loop_->QuitWhenIdle();  // Quit from uv.
 
+  DidUvRunOnce();
+
   // Tell the worker thread to continue polling.
-  uv_sem_post(&embed_sem_);
+  if (embed_thread_started_)
+    uv_sem_post(&embed_sem_);
+}
+
+bool NodeBindings::WatchBackendFd() {
+  return false;
+}
+
+void NodeBindings::DidUvRunOnce() {
 }
 
 void NodeBindings::WakeupMainThread() {
   DCHECK(message_loop_);
-  message_loop_->PostTask(FROM_HERE, base::Bind(&NodeBindings::UvRunOnce,
-                                                weak_factory_.GetWeakPtr()));
+  message_loop_->PostTask(FROM_HERE, base::Bind(&NodeBindings::OnWakeup,
+                                                weak_factory_.GetWeakPtr(),
+                                                base::TimeTicks::Now()));
+}
+
+void NodeBindings::OnWakeup(base::TimeTicks wakeup_time) {
+  EventLoopStats::Get()->RecordLoopLag(base::TimeTicks::Now() - wakeup_time);
+  UvRunOnce();
 }
 
 void NodeBindings::WakeupEmbedThread() {
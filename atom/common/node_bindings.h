@@ -7,6 +7,7 @@
 
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
@@ -51,12 +52,23 @@ class NodeBindings {
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
+  // Called before the embed thread is started, derived classes can return true
+  // when they deliver uv events to the main thread's message pump directly, in
+  // which case no embed thread is created.
+  virtual bool WatchBackendFd();
+
+  // Called after each run of the libuv loop.
+  virtual void DidUvRunOnce();
+
   // Run the libuv loop for once.
   void UvRunOnce();
 
   // Make the main thread run libuv loop.
   void WakeupMainThread();
 
+  // Run libuv loop for the wakeup posted at |wakeup_time|.
+  void OnWakeup(base::TimeTicks wakeup_time);
+
   // Interrupt the PollEvents.
   void WakeupEmbedThread();
 
@@ -76,6 +88,9 @@ class NodeBindings {
   // Whether the libuv loop has ended.
   bool embed_closed_;
 
+  // Whether the embed thread has been created.
+  bool embed_thread_started_;
+
   // Dummy handle to make uv's loop not quit.
   uv_async_t dummy_uv_handle_;
 
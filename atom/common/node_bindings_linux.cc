@@ -4,13 +4,72 @@
 
 #include "atom/common/node_bindings_linux.h"
 
+#include <glib.h>
 #include <sys/epoll.h>
 
+#include <memory>
+
+#include "atom/common/event_loop_stats.h"
+#include "base/bind.h"
+#include "base/environment.h"
+#include "base/message_loop/message_loop.h"
+
 namespace atom {
 
+namespace {
+
+// Watch uv's backend fd in the glib loop instead of polling it in the embed
+// thread.
+const char kWatchUvFdEnvVar[] = "ELECTRON_WATCH_UV_FD";
+
+struct UvSource {
+  GSource source;
+  GPollFD poll_fd;
+  NodeBindingsLinux* bindings;
+  // When the fd was found readable, to record the loop lag.
+  base::TimeTicks ready_time;
+};
+
+gboolean UvSourcePrepare(GSource* source, gint* timeout) {
+  // Timers are handled by NodeBindingsLinux::uv_timer_.
+  *timeout = -1;
+  return FALSE;
+}
+
+gboolean UvSourceCheck(GSource* source) {
+  UvSource* uv_source = reinterpret_cast<UvSource*>(source);
+  if (!(uv_source->poll_fd.revents & G_IO_IN))
+    return FALSE;
+  uv_source->ready_time = base::TimeTicks::Now();
+  return TRUE;
+}
+
+gboolean UvSourceDispatch(GSource* source,
+                          GSourceFunc unused_func,
+                          gpointer unused_data) {
+  UvSource* uv_source = reinterpret_cast<UvSource*>(source);
+  EventLoopStats::Get()->RecordLoopLag(
+      base::TimeTicks::Now() - uv_source->ready_time);
+  uv_source->bindings->RunUvLoop();
+  return TRUE;
+}
+
+GSourceFuncs kUvSourceFuncs = {
+  UvSourcePrepare,
+  UvSourceCheck,
+  UvSourceDispatch,
+  nullptr,
+};
+
+}  // namespace
+
 NodeBindingsLinux::NodeBindingsLinux(bool is_browser)
     : NodeBindings(is_browser),
-      epoll_(epoll_create(1)) {
+      epoll_(epoll_create(1)),
+      backend_fd_source_(nullptr),
+      watching_backend_fd_(false),
+      uv_running_(false),
+      watcher_queue_changed_(false) {
   int backend_fd = uv_backend_fd(uv_loop_);
   struct epoll_event ev = { 0 };
   ev.events = EPOLLIN;
@@ -19,6 +78,10 @@ NodeBindingsLinux::NodeBindingsLinux(bool is_browser)
 }
 
 NodeBindingsLinux::~NodeBindingsLinux() {
+  if (backend_fd_source_) {
+    g_source_destroy(backend_fd_source_);
+    g_source_unref(backend_fd_source_);
+  }
 }
 
 void NodeBindingsLinux::RunMessageLoop() {
@@ -26,13 +89,52 @@ void NodeBindingsLinux::RunMessageLoop() {
   uv_loop_->data = this;
   uv_loop_->on_watcher_queue_updated = OnWatcherQueueChanged;
 
+  SetUvRunning(true);
   NodeBindings::RunMessageLoop();
+  SetUvRunning(false);
+}
+
+void NodeBindingsLinux::RunUvLoop() {
+  // The outer run reschedules the loop when it is done, see DidUvRunOnce.
+  if (uv_running_)
+    return;
+
+  SetUvRunning(true);
+  UvRunOnce();
+  SetUvRunning(false);
+}
+
+void NodeBindingsLinux::SetUvRunning(bool running) {
+  uv_running_ = running;
+  if (!backend_fd_source_)
+    return;
+
+  // The backend fd stays readable until uv_run handles its events, so the
+  // source must stop polling it while uv_run is on the stack, otherwise
+  // nested message loops would keep dispatching it without making progress.
+  // Not being able to recurse does not help here when uv_run was entered from
+  // the timer instead of the source.
+  UvSource* source = reinterpret_cast<UvSource*>(backend_fd_source_);
+  if (running)
+    g_source_remove_poll(backend_fd_source_, &source->poll_fd);
+  else
+    g_source_add_poll(backend_fd_source_, &source->poll_fd);
 }
 
 // static
 void NodeBindingsLinux::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(loop->data);
 
+  // New fds are only added to uv's backend fd by uv_run, so make sure it runs
+  // soon.
+  if (self->watching_backend_fd_) {
+    if (self->uv_running_)
+      self->watcher_queue_changed_ = true;
+    else
+      self->ScheduleUvLoop(base::TimeDelta());
+    return;
+  }
+
   // We need to break the io polling in the epoll thread when loop's watcher
   // queue changes, otherwise new events cannot be notified.
   self->WakeupEmbedThread();
@@ -49,6 +151,61 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsLinux::WatchBackendFd() {
+  std::unique_ptr<base::Environment> env(base::Environment::Create());
+  if (!env->HasVar(kWatchUvFdEnvVar))
+    return false;
+
+  // Only the glib pump of the browser's UI thread can watch fds, the main
+  // loop of renderer processes keeps using the embed thread.
+  if (!base::MessageLoop::current()->IsType(base::MessageLoop::TYPE_UI))
+    return false;
+
+  backend_fd_source_ = g_source_new(&kUvSourceFuncs, sizeof(UvSource));
+  UvSource* source = reinterpret_cast<UvSource*>(backend_fd_source_);
+  source->poll_fd.fd = uv_backend_fd(uv_loop_);
+  source->poll_fd.events = G_IO_IN;
+  source->poll_fd.revents = 0;
+  source->bindings = this;
+  // The fd is polled whenever uv_run is not on the stack, see SetUvRunning.
+  if (!uv_running_)
+    g_source_add_poll(backend_fd_source_, &source->poll_fd);
+  // uv_run must not be reentered from nested message loops.
+  g_source_set_can_recurse(backend_fd_source_, FALSE);
+  g_source_attach(backend_fd_source_, g_main_context_default());
+
+  watching_backend_fd_ = true;
+  return true;
+}
+
+void NodeBindingsLinux::DidUvRunOnce() {
+  if (!watching_backend_fd_)
+    return;
+
+  // The backend fd does not become readable for timers and pending immediates,
+  // so wake up for them ourselves.
+  int timeout = watcher_queue_changed_ ? 0 : uv_backend_timeout(uv_loop_);
+  watcher_queue_changed_ = false;
+  if (timeout < 0) {
+    uv_timer_.Stop();
+    return;
+  }
+
+  ScheduleUvLoop(base::TimeDelta::FromMilliseconds(timeout));
+}
+
+void NodeBindingsLinux::ScheduleUvLoop(base::TimeDelta delay) {
+  uv_timer_.Start(FROM_HERE, delay,
+                  base::Bind(&NodeBindingsLinux::OnUvTimer,
+                             base::Unretained(this),
+                             base::TimeTicks::Now() + delay));
+}
+
+void NodeBindingsLinux::OnUvTimer(base::TimeTicks deadline) {
+  EventLoopStats::Get()->RecordLoopLag(base::TimeTicks::Now() - deadline);
+  RunUvLoop();
+}
+
 // static
 NodeBindings* NodeBindings::Create(bool is_browser) {
   return new NodeBindingsLinux(is_browser);
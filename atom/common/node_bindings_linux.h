@@ -7,6 +7,9 @@
 
 #include "atom/common/node_bindings.h"
 #include "base/compiler_specific.h"
+#include "base/timer/timer.h"
+
+typedef struct _GSource GSource;
 
 namespace atom {
 
@@ -17,15 +20,44 @@ class NodeBindingsLinux : public NodeBindings {
 
   void RunMessageLoop() override;
 
+  // Runs the uv loop on the main thread, unless it is already running.
+  void RunUvLoop();
+
  private:
   // Called when uv's watcher queue changes.
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
   void PollEvents() override;
+  bool WatchBackendFd() override;
+  void DidUvRunOnce() override;
+
+  // Updates |uv_running_| and stops watching the backend fd while uv runs.
+  void SetUvRunning(bool running);
+
+  // Runs the uv loop after |delay|, replacing the previous schedule.
+  void ScheduleUvLoop(base::TimeDelta delay);
+  void OnUvTimer(base::TimeTicks deadline);
 
   // Epoll to poll for uv's backend fd.
   int epoll_;
 
+  // Source that watches uv's backend fd in the main thread's glib loop.
+  GSource* backend_fd_source_;
+
+  // Whether uv's backend fd is watched by the main thread's message pump.
+  bool watching_backend_fd_;
+
+  // Whether uv_run is on the stack, it must not be reentered from nested
+  // message loops.
+  bool uv_running_;
+
+  // Whether uv's watcher queue changed during the current uv_run.
+  bool watcher_queue_changed_;
+
+  // Runs the uv loop when its next timer expires, the backend fd does not
+  // become readable for timers.
+  base::OneShotTimer uv_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsLinux);
 };
 
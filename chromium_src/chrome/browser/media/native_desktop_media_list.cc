@@ -13,6 +13,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/sequenced_worker_pool.h"
+#include "base/threading/worker_pool.h"
 #include "chrome/browser/media/desktop_media_list_observer.h"
 #include "content/public/browser/browser_thread.h"
 #include "media/base/video_util.h"
@@ -75,6 +76,41 @@ gfx::ImageSkia ScaleDesktopFrame(std::unique_ptr<webrtc::DesktopFrame> frame,
 
 }  // namespace
 
+// Tracks the thumbnails of a refresh being scaled in the worker pool, and
+// notifies the model when the last of them is done, so OnRefreshFinished()
+// always comes after the thumbnails of the refresh.
+class NativeDesktopMediaList::PendingRefresh
+    : public base::RefCountedThreadSafe<PendingRefresh> {
+ public:
+  explicit PendingRefresh(base::WeakPtr<NativeDesktopMediaList> media_list)
+      : media_list_(media_list) {}
+
+  // Runs in the worker pool.
+  void ScaleThumbnail(int index,
+                      std::unique_ptr<webrtc::DesktopFrame> frame,
+                      const gfx::Size& thumbnail_size) {
+    gfx::ImageSkia thumbnail =
+        ScaleDesktopFrame(std::move(frame), thumbnail_size);
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&NativeDesktopMediaList::OnSourceThumbnail,
+                   media_list_, index, thumbnail));
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<PendingRefresh>;
+
+  ~PendingRefresh() {
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&NativeDesktopMediaList::OnRefreshFinished, media_list_));
+  }
+
+  base::WeakPtr<NativeDesktopMediaList> media_list_;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingRefresh);
+};
+
 NativeDesktopMediaList::SourceDescription::SourceDescription(
     DesktopMediaID id,
     const base::string16& name)
@@ -170,8 +206,12 @@ void NativeDesktopMediaList::Worker::Refresh(
                  media_list_, sources));
 
   ImageHashesMap new_image_hashes;
+  scoped_refptr<PendingRefresh> pending_refresh(
+      new PendingRefresh(media_list_));
 
-  // Get a thumbnail for each source.
+  // Get a thumbnail for each source. The capturers can only be used on this
+  // sequence, but the changed frames are scaled in parallel in the worker
+  // pool.
   for (size_t i = 0; i < sources.size(); ++i) {
     SourceDescription& source = sources[i];
     switch (source.id.type) {
@@ -201,21 +241,25 @@ void NativeDesktopMediaList::Worker::Refresh(
       // Scale the image only if it has changed.
       ImageHashesMap::iterator it = image_hashes_.find(source.id);
       if (it == image_hashes_.end() || it->second != frame_hash) {
-        gfx::ImageSkia thumbnail =
-            ScaleDesktopFrame(std::move(current_frame_), thumbnail_size);
-        BrowserThread::PostTask(
-            BrowserThread::UI, FROM_HERE,
-            base::Bind(&NativeDesktopMediaList::OnSourceThumbnail,
-                        media_list_, i, thumbnail));
+        std::unique_ptr<webrtc::DesktopFrame> frame(std::move(current_frame_));
+        // The screen capturer reuses the buffers of its frames for the next
+        // captures, so they must be copied before leaving this sequence.
+        if (source.id.type == DesktopMediaID::TYPE_SCREEN)
+          frame.reset(webrtc::BasicDesktopFrame::CopyOf(*frame));
+        base::WorkerPool::PostTask(
+            FROM_HERE,
+            base::Bind(&PendingRefresh::ScaleThumbnail, pending_refresh,
+                       static_cast<int>(i), base::Passed(&frame),
+                       thumbnail_size),
+            false);
       }
+      current_frame_.reset();
     }
   }
 
   image_hashes_.swap(new_image_hashes);
 
-  BrowserThread::PostTask(
-      BrowserThread::UI, FROM_HERE,
-      base::Bind(&NativeDesktopMediaList::OnRefreshFinished, media_list_));
+  // OnRefreshFinished() is posted when the last scaling task releases it.
 }
 
 void NativeDesktopMediaList::Worker::OnCaptureResult(
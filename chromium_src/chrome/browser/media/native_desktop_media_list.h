@@ -38,7 +38,9 @@ class NativeDesktopMediaList : public DesktopMediaList {
   void SetViewDialogWindowId(content::DesktopMediaID::Id dialog_id) override;
 
  private:
+  class PendingRefresh;
   class Worker;
+  friend class PendingRefresh;
   friend class Worker;
 
   // Struct used to represent sources list the model gets from the Worker.
@@ -59,7 +61,8 @@ class NativeDesktopMediaList : public DesktopMediaList {
   // Called by |worker_| to refresh the model. First it posts tasks for
   // OnSourcesList() with the fresh list of sources, then follows with
   // OnSourceThumbnail() for each changed thumbnail and then calls
-  // OnRefreshFinished() at the end.
+  // OnRefreshFinished() at the end. The thumbnails may arrive in any order,
+  // but always before OnRefreshFinished().
   void OnSourcesList(const std::vector<SourceDescription>& sources);
   void OnSourceThumbnail(int index, const gfx::ImageSkia& thumbnail);
   void OnRefreshFinished();
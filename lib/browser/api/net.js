@@ -20,6 +20,7 @@ class IncomingMessage extends Readable {
     this.urlRequest = urlRequest
     this.shouldPush = false
     this.data = []
+    this.responsePaused = false
     this.urlRequest.on('data', (event, chunk) => {
       this._storeInternalData(chunk)
       this._pushInternalData()
@@ -71,11 +72,21 @@ class IncomingMessage extends Readable {
       const chunk = this.data.shift()
       this.shouldPush = this.push(chunk)
     }
+    // Stop reading from the network while the consumer is not keeping up,
+    // so the buffered response stays bounded.
+    if (!this.shouldPush && this.data.length > 0 && !this.responsePaused) {
+      this.responsePaused = true
+      this.urlRequest.pauseResponse()
+    }
   }
 
   _read () {
     this.shouldPush = true
     this._pushInternalData()
+    if (this.shouldPush && this.responsePaused) {
+      this.responsePaused = false
+      this.urlRequest.resumeResponse()
+    }
   }
 
 }
@@ -1,4 +1,5 @@
 const {EventEmitter} = require('events')
+const {Readable} = require('stream')
 const {app} = require('electron')
 const {fromPartition, Session, Cookies} = process.atomBinding('session')
 
@@ -20,3 +21,50 @@ Object.setPrototypeOf(Cookies.prototype, EventEmitter.prototype)
 Session.prototype._init = function () {
   app.emit('session-created', this)
 }
+
+// Reads a blob chunk by chunk, each chunk is handed over from the IO thread
+// without being copied.
+class BlobReadStream extends Readable {
+  constructor (session, uuid, options) {
+    const chunkSize = options.chunkSize || 64 * 1024
+    super({highWaterMark: chunkSize})
+    const start = options.start || 0
+    if (start < 0) {
+      throw new RangeError('start must be >= 0')
+    }
+    if (options.end !== undefined && options.end < start) {
+      throw new RangeError('start must be <= end')
+    }
+    const length = options.end === undefined ? -1 : options.end - start + 1
+    this.session = session
+    this.chunkSize = chunkSize
+    // The stream is also closed when this object is garbage collected.
+    this.streamId = session._openBlobStream(uuid, start, length, this)
+  }
+
+  _read () {
+    if (this.streamId === null) return
+    this.session._readBlobStream(this.streamId, this.chunkSize, (chunk) => {
+      if (this.streamId === null) return
+      if (chunk === null) {
+        this.destroy()
+        this.emit('error', new Error('Failed to read blob'))
+      } else if (chunk.length === 0) {
+        this.destroy()
+        this.push(null)
+      } else {
+        this.push(chunk)
+      }
+    })
+  }
+
+  destroy () {
+    if (this.streamId === null) return
+    this.session._closeBlobStream(this.streamId)
+    this.streamId = null
+  }
+}
+
+Session.prototype.createBlobReadStream = function (uuid, options = {}) {
+  return new BlobReadStream(this, uuid, options)
+}
@@ -1,7 +1,7 @@
 'use strict'
 
 const ipcMain = require('electron').ipcMain
-const desktopCapturer = process.atomBinding('desktop_capturer').desktopCapturer
+const {desktopCapturer, createDesktopCapturer} = process.atomBinding('desktop_capturer')
 
 var deepEqual = function (opt1, opt2) {
   return JSON.stringify(opt1) === JSON.stringify(opt2)
@@ -42,10 +42,14 @@ desktopCapturer.emit = function (event, name, sources) {
     results = []
     for (i = 0, len = sources.length; i < len; i++) {
       source = sources[i]
+      // Send the raw pixels so the renderer does not have to decode them.
       results.push({
         id: source.id,
         name: source.name,
-        thumbnail: source.thumbnail.toDataURL()
+        thumbnail: {
+          bitmap: source.thumbnail.getBitmap(),
+          size: source.thumbnail.getSize()
+        }
       })
     }
     return results
@@ -75,3 +79,46 @@ desktopCapturer.emit = function (event, name, sources) {
     return desktopCapturer.startHandling(captureWindow, captureScreen, thumbnailSize)
   }
 }
+
+// The capturers continuously watching sources, keyed by renderer and id.
+const watchers = {}
+
+const getWatcherKey = function (webContents, id) {
+  return `${webContents.getId()}-${id}`
+}
+
+const stopWatching = function (key) {
+  const capturer = watchers[key]
+  if (capturer == null) return
+  capturer.stopUpdating()
+  delete watchers[key]
+}
+
+ipcMain.on('ELECTRON_BROWSER_DESKTOP_CAPTURER_WATCH_SOURCES', function (event, captureWindow, captureScreen, thumbnailSize, updatePeriod, id) {
+  const webContents = event.sender
+  const key = getWatcherKey(webContents, id)
+  const channel = 'ELECTRON_RENDERER_DESKTOP_CAPTURER_EVENT_' + id
+  const capturer = createDesktopCapturer()
+  capturer.emit = function (name, event, ...args) {
+    if (watchers[key] !== capturer || webContents.isDestroyed()) return
+    if (name === 'source-thumbnail-changed') {
+      // Only the changed thumbnail is sent, as raw pixels like getSources.
+      const [index, sourceId, thumbnail] = args
+      args = [index, sourceId, {
+        bitmap: thumbnail.getBitmap(),
+        size: thumbnail.getSize()
+      }]
+    }
+    webContents.send(channel, name, ...args)
+  }
+  watchers[key] = capturer
+  capturer.startUpdating(captureWindow, captureScreen, thumbnailSize, updatePeriod)
+
+  webContents.once('destroyed', function () {
+    stopWatching(key)
+  })
+})
+
+ipcMain.on('ELECTRON_BROWSER_DESKTOP_CAPTURER_STOP_WATCHING', function (event, id) {
+  stopWatching(getWatcherKey(event.sender, id))
+})
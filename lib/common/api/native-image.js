@@ -1 +1,25 @@
-module.exports = process.atomBinding('native_image')
+const nativeImage = process.atomBinding('native_image')
+
+// The encoding, decoding and resizing of the async methods happen in a worker
+// pool, so they do not block the calling thread.
+const NativeImage = Object.getPrototypeOf(nativeImage.createEmpty())
+
+NativeImage.toPNGAsync = function () {
+  return new Promise((resolve) => {
+    this._toPNGAsync(resolve)
+  })
+}
+
+NativeImage.resizeAsync = function (options) {
+  return new Promise((resolve) => {
+    this._resizeAsync(options, resolve)
+  })
+}
+
+nativeImage.createFromBufferAsync = function (buffer, scaleFactor = 1) {
+  return new Promise((resolve) => {
+    nativeImage._createFromBufferAsync(buffer, scaleFactor, resolve)
+  })
+}
+
+module.exports = nativeImage
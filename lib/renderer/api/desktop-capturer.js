@@ -1,3 +1,4 @@
+const {EventEmitter} = require('events')
 const ipcRenderer = require('electron').ipcRenderer
 const nativeImage = require('electron').nativeImage
 
@@ -13,6 +14,13 @@ var isValid = function (options) {
   return ((options != null ? options.types : void 0) != null) && Array.isArray(options.types)
 }
 
+var createThumbnail = function (thumbnail) {
+  if (thumbnail.size.width === 0 || thumbnail.size.height === 0) {
+    return nativeImage.createEmpty()
+  }
+  return nativeImage.createFromBitmap(thumbnail.bitmap, thumbnail.size)
+}
+
 exports.getSources = function (options, callback) {
   var captureScreen, captureWindow, id
   if (!isValid(options)) {
@@ -38,10 +46,52 @@ exports.getSources = function (options, callback) {
         results.push({
           id: source.id,
           name: source.name,
-          thumbnail: nativeImage.createFromDataURL(source.thumbnail)
+          thumbnail: createThumbnail(source.thumbnail)
         })
       }
       return results
     })())
   })
 }
+
+// Emits the changes of the sources reported by the browser process.
+class SourceWatcher extends EventEmitter {
+  constructor (id) {
+    super()
+    this.id = id
+    this.channel = 'ELECTRON_RENDERER_DESKTOP_CAPTURER_EVENT_' + id
+    this.listener = (ipcEvent, eventName, ...args) => {
+      // Listeners receive an event object first, like the other emitters.
+      const event = {sender: this}
+      if (eventName === 'source-added') {
+        const [index, id, name] = args
+        this.emit(eventName, event, index, {id, name})
+        return
+      }
+      if (eventName === 'source-thumbnail-changed') {
+        args[2] = createThumbnail(args[2])
+      }
+      this.emit(eventName, event, ...args)
+    }
+    ipcRenderer.on(this.channel, this.listener)
+  }
+
+  stop () {
+    ipcRenderer.removeListener(this.channel, this.listener)
+    ipcRenderer.send('ELECTRON_BROWSER_DESKTOP_CAPTURER_STOP_WATCHING', this.id)
+  }
+}
+
+exports.watchSources = function (options) {
+  if (!isValid(options)) {
+    throw new Error('Invalid options')
+  }
+  const captureWindow = includes.call(options.types, 'window')
+  const captureScreen = includes.call(options.types, 'screen')
+  const thumbnailSize = options.thumbnailSize || {width: 150, height: 150}
+  const updatePeriod = options.updatePeriod || 1000
+  const id = getNextId()
+  const watcher = new SourceWatcher(id)
+  ipcRenderer.send('ELECTRON_BROWSER_DESKTOP_CAPTURER_WATCH_SOURCES', captureWindow, captureScreen, thumbnailSize, updatePeriod, id)
+  return watcher
+}
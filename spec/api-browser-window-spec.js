@@ -354,6 +354,24 @@ describe('browser-window module', function () {
         done()
       })
     })
+
+    it('calls the callback with encoded data when a format is given', function (done) {
+      w.capturePage({
+        rect: {x: 0, y: 0, width: 100, height: 100},
+        scaleTo: {width: 50},
+        format: 'png'
+      }, function (data) {
+        assert(Buffer.isBuffer(data))
+        assert.equal(data.length, 0)
+        done()
+      })
+    })
+
+    it('throws on invalid formats', function () {
+      assert.throws(function () {
+        w.capturePage({format: 'gif'}, function () {})
+      }, /Invalid format/)
+    })
   })
 
   describe('BrowserWindow.setSize(width, height)', function () {
@@ -1667,6 +1685,51 @@ describe('browser-window module', function () {
       w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
     })
 
+    it('creates offscreen window with tiled rendering', function (done) {
+      w.destroy()
+      w = new BrowserWindow({
+        show: false,
+        width: 1024,
+        height: 768,
+        webPreferences: {
+          backgroundThrottling: false,
+          offscreen: true,
+          offscreenTiledRendering: true
+        }
+      })
+      w.webContents.once('paint', function (event, rect, data, size) {
+        assert.notEqual(data.length, 0)
+        done()
+      })
+      w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
+    })
+
+    it('captures the pixels of a tiled offscreen window', function (done) {
+      w.destroy()
+      w = new BrowserWindow({
+        show: false,
+        width: 400,
+        height: 400,
+        webPreferences: {
+          backgroundThrottling: false,
+          offscreen: true,
+          offscreenTiledRendering: true
+        }
+      })
+      w.webContents.once('paint', function () {
+        w.capturePage(function (image) {
+          assert.equal(image.isEmpty(), false)
+          // The page is red, whichever of BGRA or RGBA the bitmap uses.
+          const bitmap = image.toBitmap()
+          assert.equal(bitmap[0] + bitmap[2], 255)
+          assert.equal(bitmap[1], 0)
+          assert.equal(bitmap[3], 255)
+          done()
+        })
+      })
+      w.loadURL('data:text/html,<body style="background: #f00"></body>')
+    })
+
     describe('window.webContents.isOffscreen()', function () {
       it('is true for offscreen type', function () {
         w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
@@ -1725,6 +1788,85 @@ describe('browser-window module', function () {
       })
     })
 
+    describe('window.webContents.setFramePriority(priority)', function () {
+      it('sets custom frame priority', function (done) {
+        w.webContents.on('dom-ready', function () {
+          w.webContents.setFramePriority(10)
+          w.webContents.once('paint', function (event, rect, data, size) {
+            assert.equal(w.webContents.getFramePriority(), 10)
+            done()
+          })
+        })
+        w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
+      })
+    })
+
+    describe('app.setOffscreenFrameBudget(budget)', function () {
+      afterEach(function () {
+        app.setOffscreenFrameBudget(0)
+      })
+
+      it('keeps painting when over budget', function (done) {
+        app.setOffscreenFrameBudget(1)
+        assert.equal(app.getOffscreenFrameBudget(), 1)
+        w.webContents.once('paint', function (event, rect, data, size) {
+          assert.notEqual(data.length, 0)
+          done()
+        })
+        w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
+      })
+
+      it('still paints low priority pages when over budget', function (done) {
+        this.timeout(20000)
+        // Pages that repaint everything so that every paint uses up the budget.
+        const options = {
+          show: false,
+          width: 1920,
+          height: 1080,
+          webPreferences: {
+            backgroundThrottling: false,
+            offscreen: true
+          }
+        }
+        w.destroy()
+        w = new BrowserWindow(options)
+        const w2 = new BrowserWindow(options)
+        let paints = 0
+        let paints2 = 0
+        let overBudget = false
+        w.webContents.on('paint', function () {
+          ++paints
+          if (overBudget) return
+          if (paints >= 10 && paints2 >= 10) startBudget()
+        })
+        w2.webContents.on('paint', function () {
+          ++paints2
+          if (!overBudget) {
+            if (paints >= 10 && paints2 >= 10) startBudget()
+            return
+          }
+          // The low priority page waits 20 ticks for every frame it gets.
+          if (paints2 === 100) {
+            assert(paints >= 2, `got ${paints} frames`)
+            w2.destroy()
+            done()
+          }
+        })
+        // Both pages have painted for a while, so their costs are known and
+        // only one of them fits in the budget of every tick.
+        const startBudget = function () {
+          overBudget = true
+          paints = 0
+          paints2 = 0
+          w.webContents.setFramePriority(-10)
+          w2.webContents.setFramePriority(10)
+          app.setOffscreenFrameBudget(1)
+        }
+        w.loadURL('file://' + fixtures + '/api/offscreen-rendering-full.html')
+        w2.loadURL('file://' + fixtures + '/api/offscreen-rendering-full.html')
+      })
+    })
+
     describe('window.webContents.setFrameRate(frameRate)', function () {
       it('sets custom frame rate', function (done) {
         w.webContents.on('dom-ready', function () {
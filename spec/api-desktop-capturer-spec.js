@@ -49,4 +49,24 @@ describe('desktopCapturer', function () {
     desktopCapturer.getSources({types: ['window']}, callback)
     desktopCapturer.getSources({types: ['screen']}, callback)
   })
+
+  it('emits the sources added when watching sources', function (done) {
+    const watcher = desktopCapturer.watchSources({types: ['screen']})
+    let added = 0
+    watcher.on('source-added', function (event, index, source) {
+      assert.equal(typeof source.id, 'string')
+      added++
+    })
+    watcher.once('refresh-finished', function () {
+      watcher.stop()
+      assert.notEqual(added, 0)
+      done()
+    })
+  })
+
+  it('throws an error for invalid options when watching sources', function () {
+    assert.throws(function () {
+      desktopCapturer.watchSources(['window', 'screen'])
+    }, /Invalid options/)
+  })
 })
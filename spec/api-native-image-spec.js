@@ -28,6 +28,37 @@ describe('nativeImage module', () => {
     })
   })
 
+  describe('createFromBitmap(buffer, options)', () => {
+    it('returns an image created from the given bitmap', () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+      const imageB = nativeImage.createFromBitmap(imageA.getBitmap(), imageA.getSize())
+      assert.deepEqual(imageB.getSize(), {width: 538, height: 190})
+      assert(imageA.toBitmap().equals(imageB.toBitmap()))
+    })
+
+    it('throws when the buffer is too small', () => {
+      assert.throws(() => {
+        nativeImage.createFromBitmap(Buffer.from([1, 2, 3]), {width: 10, height: 10})
+      }, /Invalid bitmap size/)
+    })
+  })
+
+  describe('createFromBufferAsync(buffer, scaleFactor)', () => {
+    it('resolves with an empty image when the buffer is empty', () => {
+      return nativeImage.createFromBufferAsync(Buffer.from([])).then((image) => {
+        assert(image.isEmpty())
+      })
+    })
+
+    it('resolves with an image created from the given buffer', () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+      return nativeImage.createFromBufferAsync(imageA.toPNG()).then((imageB) => {
+        assert.deepEqual(imageB.getSize(), {width: 538, height: 190})
+        assert(imageA.toBitmap().equals(imageB.toBitmap()))
+      })
+    })
+  })
+
   describe('createFromDataURL(dataURL)', () => {
     it('returns an empty image when the dataURL is empty', () => {
       assert(nativeImage.createFromDataURL('').isEmpty())
@@ -123,6 +154,31 @@ describe('nativeImage module', () => {
     })
   })
 
+  describe('resizeAsync(options)', () => {
+    it('resolves with a resized image', () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+      return image.resizeAsync({width: 269}).then((resized) => {
+        assert.deepEqual(resized.getSize(), {width: 269, height: 95})
+        assert(resized.toBitmap().equals(image.resize({width: 269}).toBitmap()))
+      })
+    })
+
+    it('resolves with an empty image when called on an empty image', () => {
+      return nativeImage.createEmpty().resizeAsync({width: 1, height: 1}).then((resized) => {
+        assert(resized.isEmpty())
+      })
+    })
+  })
+
+  describe('toPNGAsync()', () => {
+    it('resolves with the same data as toPNG()', () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+      return image.toPNGAsync().then((png) => {
+        assert(png.equals(image.toPNG()))
+      })
+    })
+  })
+
   describe('crop(bounds)', () => {
     it('returns an empty image when called on an empty image', () => {
       assert(nativeImage.createEmpty().crop({width: 1, height: 2, x: 0, y: 0}).isEmpty())
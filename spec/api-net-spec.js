@@ -129,6 +129,70 @@ describe('net module', function () {
       urlRequest.end()
     })
 
+    it('should fetch correct data in a large GET response', function (done) {
+      const requestUrl = '/requestUrl'
+      const bodyData = randomBuffer(4 * kOneMegaByte)
+      server.on('request', function (request, response) {
+        switch (request.url) {
+          case requestUrl:
+            // Write in pieces so the response arrives in several reads.
+            for (let i = 0; i < bodyData.length; i += 100 * kOneKiloByte) {
+              response.write(bodyData.slice(i, i + 100 * kOneKiloByte))
+            }
+            response.end()
+            break
+          default:
+            assert(false)
+        }
+      })
+      const urlRequest = net.request(`${server.url}${requestUrl}`)
+      urlRequest.on('response', function (response) {
+        const chunks = []
+        assert.equal(response.statusCode, 200)
+        response.pause()
+        response.on('data', function (chunk) {
+          chunks.push(Buffer.from(chunk))
+        })
+        response.on('end', function () {
+          assert(Buffer.concat(chunks).equals(bodyData))
+          done()
+        })
+        response.resume()
+      })
+      urlRequest.end()
+    })
+
+    it('should deliver all data to a slow consumer', function (done) {
+      const requestUrl = '/requestUrl'
+      const bodyData = randomBuffer(4 * kOneMegaByte)
+      server.on('request', function (request, response) {
+        switch (request.url) {
+          case requestUrl:
+            response.end(bodyData)
+            break
+          default:
+            assert(false)
+        }
+      })
+      const urlRequest = net.request(`${server.url}${requestUrl}`)
+      urlRequest.on('response', function (response) {
+        const chunks = []
+        assert.equal(response.statusCode, 200)
+        response.on('data', function (chunk) {
+          chunks.push(Buffer.from(chunk))
+          response.pause()
+          setTimeout(function () {
+            response.resume()
+          }, 5)
+        })
+        response.on('end', function () {
+          assert(Buffer.concat(chunks).equals(bodyData))
+          done()
+        })
+      })
+      urlRequest.end()
+    })
+
     it('should post the correct data in a POST request', function (done) {
       const requestUrl = '/requestUrl'
       const bodyData = 'Hello World!'
@@ -222,6 +286,175 @@ describe('net module', function () {
       }
       urlRequest.end()
     })
+
+    it('should emit drain when a chunked upload can take more data', function (done) {
+      const requestUrl = '/requestUrl'
+      const bodyData = randomBuffer(8 * kOneMegaByte)
+      const chunkSize = 256 * kOneKiloByte
+      server.on('request', function (request, response) {
+        let receivedChunks = []
+        switch (request.url) {
+          case requestUrl:
+            request.on('data', function (chunk) {
+              receivedChunks.push(chunk)
+            })
+            request.on('end', function () {
+              assert(Buffer.concat(receivedChunks).equals(bodyData))
+              response.end()
+            })
+            break
+          default:
+            assert(false)
+        }
+      })
+      const urlRequest = net.request({
+        method: 'POST',
+        url: `${server.url}${requestUrl}`
+      })
+      let offset = 0
+      let drained = false
+      const writeChunks = function () {
+        while (offset < bodyData.length) {
+          const chunk = bodyData.slice(offset, offset + chunkSize)
+          offset += chunkSize
+          if (!urlRequest.write(chunk)) {
+            return
+          }
+        }
+        urlRequest.end()
+      }
+      urlRequest.on('drain', function () {
+        drained = true
+        writeChunks()
+      })
+      urlRequest.on('response', function (response) {
+        assert.equal(response.statusCode, 200)
+        response.on('data', function () {})
+        response.on('end', function () {
+          assert(drained)
+          done()
+        })
+      })
+      urlRequest.chunkedEncoding = true
+      writeChunks()
+    })
+
+    it('should send a small chunked body again after a 307 redirect', function (done) {
+      const requestUrl = '/requestUrl'
+      const redirectUrl = '/redirectUrl'
+      const bodyData = randomBuffer(kOneKiloByte)
+      server.on('request', function (request, response) {
+        let receivedChunks = []
+        request.on('data', function (chunk) {
+          receivedChunks.push(chunk)
+        })
+        request.on('end', function () {
+          switch (request.url) {
+            case requestUrl:
+              response.statusCode = 307
+              response.setHeader('Location', redirectUrl)
+              response.end()
+              break
+            case redirectUrl:
+              assert(Buffer.concat(receivedChunks).equals(bodyData))
+              response.end()
+              break
+            default:
+              assert(false)
+          }
+        })
+      })
+      const urlRequest = net.request({
+        method: 'POST',
+        url: `${server.url}${requestUrl}`
+      })
+      urlRequest.on('response', function (response) {
+        assert.equal(response.statusCode, 200)
+        response.on('data', function () {})
+        response.on('end', function () {
+          done()
+        })
+      })
+      urlRequest.chunkedEncoding = true
+      urlRequest.end(bodyData)
+    })
+
+    it('should fail a 307 redirect after more than 1MB of chunked body', function (done) {
+      const requestUrl = '/requestUrl'
+      server.on('request', function (request, response) {
+        request.on('data', function () {})
+        request.on('end', function () {
+          switch (request.url) {
+            case requestUrl:
+              response.statusCode = 307
+              response.setHeader('Location', '/redirectUrl')
+              response.end()
+              break
+            default:
+              assert(false)
+          }
+        })
+      })
+      const urlRequest = net.request({
+        method: 'POST',
+        url: `${server.url}${requestUrl}`
+      })
+      urlRequest.on('response', function () {
+        assert(false)
+      })
+      urlRequest.on('error', function (error) {
+        assert.equal(error.message, 'net::ERR_UPLOAD_STREAM_REWIND_NOT_SUPPORTED')
+        done()
+      })
+      urlRequest.chunkedEncoding = true
+      urlRequest.write(randomBuffer(kOneMegaByte))
+      urlRequest.end(randomBuffer(kOneKiloByte))
+    })
+
+    it('should send the data of a Buffer refilled in the write callback', function (done) {
+      const requestUrl = '/requestUrl'
+      const chunkCount = 16
+      const buffer = Buffer.alloc(kOneKiloByte)
+      let sentChunks = []
+      server.on('request', function (request, response) {
+        let receivedChunks = []
+        switch (request.url) {
+          case requestUrl:
+            request.on('data', function (chunk) {
+              receivedChunks.push(chunk)
+            })
+            request.on('end', function () {
+              assert(Buffer.concat(receivedChunks).equals(Buffer.concat(sentChunks)))
+              response.end()
+            })
+            break
+          default:
+            assert(false)
+        }
+      })
+      const urlRequest = net.request({
+        method: 'POST',
+        url: `${server.url}${requestUrl}`
+      })
+      const writeChunk = function () {
+        if (sentChunks.length === chunkCount) {
+          urlRequest.end()
+          return
+        }
+        buffer.fill(sentChunks.length)
+        sentChunks.push(Buffer.from(buffer))
+        urlRequest.write(buffer, writeChunk)
+      }
+      urlRequest.on('response', function (response) {
+        assert.equal(response.statusCode, 200)
+        response.on('data', function () {})
+        response.on('end', function () {
+          done()
+        })
+      })
+      urlRequest.chunkedEncoding = true
+      writeChunk()
+    })
   })
 
   describe('ClientRequest API', function () {
@@ -285,6 +285,44 @@ describe('protocol module', function () {
       })
     })
 
+    it('reuses the response when cache is set', function (done) {
+      var calls = 0
+      var handler = function (request, callback) {
+        calls++
+        callback({
+          data: buffer,
+          mimeType: 'text/html',
+          cache: {maxAge: 60}
+        })
+      }
+      protocol.registerBufferProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        var url = protocolName + '://fake-host/cached'
+        $.ajax({
+          url: url,
+          success: function (data) {
+            assert.equal(data, text)
+            $.ajax({
+              url: url,
+              success: function (data) {
+                assert.equal(data, text)
+                assert.equal(calls, 1)
+                done()
+              },
+              error: function (xhr, errorType, error) {
+                done(error)
+              }
+            })
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
     it('fails when sending string', function (done) {
       var handler = function (request, callback) {
         callback(text)
@@ -569,6 +607,209 @@ describe('protocol module', function () {
     })
   })
 
+  describe('protocol.registerStreamProtocol', function () {
+    const {PassThrough} = remote.require('stream')
+
+    it('sends stream as response', function (done) {
+      var handler = function (request, callback) {
+        var stream = new PassThrough()
+        callback(stream)
+        stream.write(text.substr(0, 5))
+        stream.end(text.substr(5))
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data) {
+            assert.equal(data, text)
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends object as response', function (done) {
+      var handler = function (request, callback) {
+        var stream = new PassThrough()
+        callback({
+          statusCode: 201,
+          mimeType: 'text/plain',
+          headers: {'X-Great-Header': 'sogreat'},
+          data: stream
+        })
+        stream.end(text)
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data, status, request) {
+            assert.equal(data, text)
+            assert.equal(request.status, 201)
+            assert.equal(request.getResponseHeader('Content-Type'), 'text/plain')
+            assert.equal(request.getResponseHeader('X-Great-Header'), 'sogreat')
+            assert.equal(request.getResponseHeader('Access-Control-Allow-Origin'), '*')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends large stream in chunks', function (done) {
+      var chunk = new Array(64 * 1024 + 1).join('a')
+      var count = 16
+      var handler = function (request, callback) {
+        var stream = new PassThrough()
+        callback(stream)
+        for (var i = 0; i < count; i++) {
+          stream.write(chunk)
+        }
+        stream.end()
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data) {
+            assert.equal(data.length, chunk.length * count)
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('fails when sending string', function (done) {
+      var handler = function (request, callback) {
+        callback(text)
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function () {
+            done('request succeeded but it should not')
+          },
+          error: function (xhr, errorType) {
+            assert.equal(errorType, 'error')
+            done()
+          }
+        })
+      })
+    })
+  })
+
+  describe('protocol.registerWorkerProtocol', function () {
+    var script = path.join(__dirname, 'fixtures', 'api', 'protocol-worker.js')
+
+    it('sends the response of the worker script', function (done) {
+      protocol.registerWorkerProtocol(protocolName, {script: script}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data) {
+            assert.equal(data, 'worker:GET')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('can read files in the worker script', function (done) {
+      var filePath = path.join(__dirname, 'fixtures', 'pages', 'a.html')
+      var fileContent = require('fs').readFileSync(filePath, 'utf8')
+      protocol.registerWorkerProtocol(protocolName, {script: script, workers: 2}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host/?path=' + encodeURIComponent(filePath),
+          cache: false,
+          success: function (data) {
+            assert.equal(data, fileContent)
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('reads files with an encoding in the worker script', function (done) {
+      var filePath = path.join(__dirname, 'fixtures', 'pages', 'a.html')
+      var fileContent = require('fs').readFileSync(filePath, 'hex')
+      protocol.registerWorkerProtocol(protocolName, {script: script}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host/?encoding=hex&path=' + encodeURIComponent(filePath),
+          cache: false,
+          success: function (data) {
+            assert.equal(data, fileContent)
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('provides Buffer to the worker script', function (done) {
+      protocol.registerWorkerProtocol(protocolName, {script: script}, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host/?buffer',
+          cache: false,
+          success: function (data) {
+            assert.equal(data, 'worker:\u00e9')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('throws when script is not an absolute path', function () {
+      assert.throws(function () {
+        protocol.registerWorkerProtocol(protocolName, {script: 'worker.js'})
+      }, /absolute path/)
+    })
+  })
+
   describe('protocol.isProtocolHandled', function () {
     it('returns true for about:', function (done) {
       protocol.isProtocolHandled('about', function (result) {
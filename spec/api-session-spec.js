@@ -126,6 +126,40 @@ describe('session module', function () {
       })
     })
 
+    it('should get cookies in pages', function (done) {
+      var cookies = session.fromPartition('cookies-pages').cookies
+      var setCookie = function (name, callback) {
+        cookies.set({url: url, name: name, value: name}, function (error) {
+          if (error) return done(error)
+          callback()
+        })
+      }
+      setCookie('a', function () {
+        setCookie('b', function () {
+          setCookie('c', function () {
+            cookies.get({domain: '127.0.0.1', limit: 2}, function (error, list, nextCursor) {
+              if (error) return done(error)
+              assert.deepEqual(list.map(function (cookie) { return cookie.name }), ['a', 'b'])
+              assert.notEqual(nextCursor, '')
+              cookies.get({domain: '127.0.0.1', limit: 2, cursor: nextCursor}, function (error, list, nextCursor) {
+                if (error) return done(error)
+                assert.deepEqual(list.map(function (cookie) { return cookie.name }), ['c'])
+                assert.equal(nextCursor, '')
+                done()
+              })
+            })
+          })
+        })
+      })
+    })
+
+    it('calls back with an error for an invalid cursor', function (done) {
+      session.defaultSession.cookies.get({cursor: '!'}, function (error) {
+        assert.equal(error.message, 'Invalid cursor')
+        done()
+      })
+    })
+
     it('should remove cookies', function (done) {
       session.defaultSession.cookies.set({
         url: url,
@@ -211,6 +245,129 @@ describe('session module', function () {
         if (error) return done(error)
       })
     })
+    it('sets and removes many cookies at once', function (done) {
+      const {cookies} = session.fromPartition('cookies-many')
+      const names = ['a', 'b', 'c']
+
+      cookies.once('batch-changed', function (event, changes) {
+        assert.deepEqual(changes.map(function (change) { return change.cookie.name }), names)
+      })
+
+      cookies.setMany(names.map(function (name) {
+        return {url: url, name: name, value: name}
+      }), function (error) {
+        if (error) return done(error)
+        cookies.get({url: url}, function (error, list) {
+          if (error) return done(error)
+          assert.deepEqual(list.map(function (cookie) { return cookie.name }).sort(), names)
+          cookies.removeMany(names.map(function (name) {
+            return {url: url, name: name}
+          }), function (error) {
+            if (error) return done(error)
+            cookies.get({url: url}, function (error, list) {
+              if (error) return done(error)
+              assert.equal(list.length, 0)
+              done()
+            })
+          })
+        })
+      })
+    })
+
+    it('reports an error when removing cookies without a name', function (done) {
+      const {cookies} = session.fromPartition('cookies-many')
+      cookies.removeMany([{url: url}], function (error) {
+        assert.equal(error.message, 'Removing cookie failed')
+        done()
+      })
+    })
+
+    it('exports cookies as newline-delimited JSON', function (done) {
+      const {cookies} = session.fromPartition('cookies-export')
+      const exportPath = path.join(remote.app.getPath('temp'), 'electron-cookies-export.ndjson')
+      cookies.set({url: url, name: 'foo', value: 'bar'}, function (error) {
+        if (error) return done(error)
+        cookies.export(exportPath, function (error, count) {
+          if (error) return done(error)
+          assert.equal(count, 1)
+          const lines = fs.readFileSync(exportPath, 'utf8').split('\n')
+          fs.unlinkSync(exportPath)
+          assert.equal(lines.length, 2)
+          const cookie = JSON.parse(lines[0])
+          assert.equal(cookie.name, 'foo')
+          assert.equal(cookie.value, 'bar')
+          done()
+        })
+      })
+    })
+  })
+
+  describe('ses.cache', function () {
+    it('lists, evicts and counts cached responses', function (done) {
+      const {cache} = session.defaultSession
+      const server = http.createServer(function (req, res) {
+        res.setHeader('Cache-Control', 'max-age=3600')
+        res.end('cached')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        const serverUrl = url + ':' + server.address().port + '/'
+        w.webContents.once('did-finish-load', function () {
+          cache.entries({urlPrefix: serverUrl}, function (entries) {
+            assert.equal(entries.length, 1)
+            assert.equal(entries[0].url, serverUrl)
+            assert(entries[0].size > 0)
+            cache.stats(function (stats) {
+              assert(stats.entryCount >= 1)
+              assert(stats.misses >= 1)
+              assert(stats.hitRate >= 0 && stats.hitRate < 1)
+              cache.evict({urls: [serverUrl + '*']}, function (count) {
+                assert.equal(count, 1)
+                cache.entries({urlPrefix: serverUrl}, function (entries) {
+                  assert.equal(entries.length, 0)
+                  server.close()
+                  done()
+                })
+              })
+            })
+          })
+        })
+        w.loadURL(serverUrl)
+      })
+    })
+  })
+
+  describe('session.fromPartition(partition, {cache: \'memory\'})', function () {
+    it('keeps the cache of a persistent partition in memory', function (done) {
+      const ses = session.fromPartition('persist:memory-cache', {cache: 'memory', maxCacheBytes: 1024 * 1024})
+      const server = http.createServer(function (req, res) {
+        res.setHeader('Cache-Control', 'max-age=3600')
+        res.end('cached')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        const serverUrl = url + ':' + server.address().port + '/'
+        w.destroy()
+        w = new BrowserWindow({
+          show: false,
+          webPreferences: {partition: 'persist:memory-cache'}
+        })
+        w.webContents.once('did-finish-load', function () {
+          ses.cache.entries({urlPrefix: serverUrl}, function (entries) {
+            assert.equal(entries.length, 1)
+            const cachePath = path.join(remote.app.getPath('userData'), 'Partitions', 'memory-cache', 'Cache')
+            assert(!fs.existsSync(cachePath))
+            server.close()
+            done()
+          })
+        })
+        w.loadURL(serverUrl)
+      })
+    })
+
+    it('throws for an unknown cache type', function () {
+      assert.throws(function () {
+        session.fromPartition('persist:bad-cache', {cache: 'memroy'})
+      }, /Invalid cache option: memroy/)
+    })
   })
 
   describe('ses.clearStorageData(options)', function () {
@@ -509,6 +666,58 @@ describe('session module', function () {
     })
   })
 
+  describe('ses.createBlobReadStream(identifier, options)', function () {
+    it('reads a range of the blob in chunks', function (done) {
+      const scheme = 'temp-stream'
+      const protocol = session.defaultSession.protocol
+      const url = scheme + '://host'
+      const postData = 'hello blob stream'
+      const content = `<html>
+                       <script>
+                       const {webFrame} = require('electron')
+                       webFrame.registerURLSchemeAsPrivileged('${scheme}')
+                       let fd = new FormData();
+                       fd.append('file', new Blob(['${postData}'], {type:'text/plain'}));
+                       fetch('${url}', {method:'POST', body: fd });
+                       </script>
+                       </html>`
+
+      const finish = function (error) {
+        protocol.unregisterProtocol(scheme, () => done(error))
+      }
+      protocol.registerStringProtocol(scheme, function (request, callback) {
+        if (request.method === 'GET') {
+          callback({data: content, mimeType: 'text/html'})
+        } else if (request.method === 'POST') {
+          const uuid = request.uploadData[1].blobUUID
+          const stream = session.defaultSession.createBlobReadStream(uuid, {start: 6, end: 15, chunkSize: 4})
+          const chunks = []
+          stream.on('data', function (chunk) {
+            chunks.push(chunk.toString())
+          })
+          stream.on('end', function () {
+            try {
+              assert.deepEqual(chunks, ['blob', ' str', 'ea'])
+              finish()
+            } catch (error) {
+              finish(error)
+            }
+          })
+          stream.on('error', finish)
+        }
+      }, function (error) {
+        if (error) return done(error)
+        w.loadURL(url)
+      })
+    })
+
+    it('throws for an inverted range', function () {
+      assert.throws(function () {
+        session.defaultSession.createBlobReadStream('uuid', {start: 10, end: 5})
+      }, /start must be <= end/)
+    })
+  })
+
   describe('ses.setCertificateVerifyProc(callback)', function () {
     var server = null
 
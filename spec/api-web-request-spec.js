@@ -85,6 +85,87 @@ describe('webRequest module', function () {
       })
     })
 
+    it('matches the path without a trailing slash of a "/*" pattern', function (done) {
+      ses.webRequest.onBeforeRequest({urls: [defaultURL + 'filter/*']}, function (details, callback) {
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL + 'filter',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('matches data URLs with <all_urls>', function (done) {
+      ses.webRequest.onBeforeRequest({urls: ['<all_urls>']}, function (details, callback) {
+        callback({})
+        if (details.url.startsWith('data:')) done()
+      })
+      remote.net.request({url: 'data:text/plain,hello'}).end()
+    })
+
+    it('only passes the requested fields', function (done) {
+      ses.webRequest.onBeforeRequest({fields: ['url', 'method']}, function (details, callback) {
+        assert.deepEqual(Object.keys(details).sort(), ['method', 'url'])
+        assert.equal(details.url, defaultURL)
+        assert.equal(details.method, 'GET')
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL,
+        success: function () {
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('throws for unknown fields', function () {
+      assert.throws(function () {
+        ses.webRequest.onBeforeRequest({fields: ['url', 'uri']}, function () {})
+      }, /Unknown details field: uri/)
+    })
+
+    it('can filter URLs with many patterns', function (done) {
+      var urls = []
+      for (var i = 0; i < 1000; ++i) {
+        urls.push('http://*.host' + i + '.com/*')
+        urls.push('https://host' + i + '.com/path/*')
+      }
+      urls.push(defaultURL + 'filter/*')
+      ses.webRequest.onBeforeRequest({urls: urls}, function (details, callback) {
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL + 'nofilter/test',
+        success: function (data) {
+          assert.equal(data, '/nofilter/test')
+          $.ajax({
+            url: defaultURL + 'filter/test',
+            success: function () {
+              done('unexpected success')
+            },
+            error: function () {
+              done()
+            }
+          })
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
     it('receives details object', function (done) {
       ses.webRequest.onBeforeRequest(function (details, callback) {
         assert.equal(typeof details.id, 'number')
@@ -457,4 +538,90 @@ describe('webRequest module', function () {
       })
     })
   })
+
+  describe('webRequest.setRules', function () {
+    afterEach(function () {
+      ses.webRequest.setRules(null)
+      ses.webRequest.onBeforeRequest(null)
+      ses.webRequest.onHeadersReceived(null)
+    })
+
+    it('can cancel the request', function (done) {
+      ses.webRequest.setRules([{urls: [defaultURL + 'filter/*'], cancel: true}])
+      $.ajax({
+        url: defaultURL + 'nofilter/test',
+        success: function (data) {
+          assert.equal(data, '/nofilter/test')
+          $.ajax({
+            url: defaultURL + 'filter/test',
+            success: function () {
+              done('unexpected success')
+            },
+            error: function () {
+              done()
+            }
+          })
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('can redirect the request without calling the listener', function (done) {
+      ses.webRequest.setRules([{
+        urls: [defaultURL + 'filter/*'],
+        redirectURL: defaultURL + 'redirected'
+      }])
+      ses.webRequest.onBeforeRequest(function (details, callback) {
+        assert.notEqual(details.url, defaultURL + 'filter/test')
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL + 'filter/test',
+        success: function (data) {
+          assert.equal(data, '/redirected')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('can change the headers', function (done) {
+      ses.webRequest.setRules([{
+        addRequestHeaders: {Accept: '*/*;test/header'},
+        removeResponseHeaders: ['Custom'],
+        addResponseHeaders: {Rule: 'Added'}
+      }])
+      ses.webRequest.onHeadersReceived(function (details, callback) {
+        assert.equal(details.responseHeaders['Custom'], undefined)
+        assert.deepEqual(details.responseHeaders['Rule'], ['Added'])
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/header/received')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('throws for invalid rules', function () {
+      assert.throws(function () {
+        ses.webRequest.setRules([{addRequestHeaders: {'Bad Name': 'value'}}])
+      })
+    })
+
+    it('throws for rules with invalid URL patterns', function () {
+      assert.throws(function () {
+        ses.webRequest.setRules([{urls: ['http//bad-pattern'], cancel: true}])
+      })
+    })
+  })
 })
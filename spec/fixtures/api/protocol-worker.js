@@ -0,0 +1,19 @@
+/* global fs, Buffer */
+/* eslint-disable no-unused-vars */
+
+function handleRequest (request) {
+  const match = /[?&]path=([^&]*)/.exec(request.url)
+  const encoding = /[?&]encoding=([^&]*)/.exec(request.url)
+  if (match && encoding) {
+    const path = decodeURIComponent(match[1])
+    return {mimeType: 'text/plain', data: fs.readFileSync(path, {encoding: encoding[1]})}
+  }
+  if (match) {
+    return {mimeType: 'text/plain', data: fs.readFileSync(decodeURIComponent(match[1]))}
+  }
+  if (/[?&]buffer/.test(request.url)) {
+    const data = Buffer.concat([Buffer.from('worker:'), Buffer.from('c3a9', 'hex')])
+    return {mimeType: 'text/plain', data: data.slice(0, 7).toString() + data.slice(7).toString()}
+  }
+  return {mimeType: 'text/plain', data: 'worker:' + request.method}
+}
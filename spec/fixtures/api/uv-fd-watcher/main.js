@@ -0,0 +1,20 @@
+const {app} = require('electron')
+const net = require('net')
+
+app.on('ready', function () {
+  setImmediate(function () {
+    setTimeout(function () {
+      const server = net.createServer(function (socket) {
+        socket.end('pong')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        const client = net.connect(server.address().port, '127.0.0.1')
+        client.on('data', function (data) {
+          console.log(String(data))
+          server.close()
+          app.exit(0)
+        })
+      })
+    }, 10)
+  })
+})
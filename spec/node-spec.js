@@ -196,6 +196,25 @@ describe('node feature', function () {
         })
       })
     })
+
+    describe('ELECTRON_WATCH_UV_FD', function () {
+      it('runs uv callbacks in the browser process', function (done) {
+        if (process.platform !== 'linux') return done()
+
+        const appPath = path.join(fixtures, 'api', 'uv-fd-watcher')
+        const env = Object.assign({}, process.env, {ELECTRON_WATCH_UV_FD: '1'})
+        const child = ChildProcess.spawn(remote.process.execPath, [appPath], {env: env})
+        let output = ''
+        child.stdout.on('data', function (data) {
+          output += data
+        })
+        child.on('close', function (code) {
+          assert.equal(code, 0)
+          assert.notEqual(output.indexOf('pong'), -1)
+          done()
+        })
+      })
+    })
   })
 
   describe('net.connect', function () {
@@ -279,6 +298,23 @@ describe('node feature', function () {
     })
   })
 
+  describe('process.getEventLoopStats()', function () {
+    it('returns loop lag and handler timings', function () {
+      const stats = process.getEventLoopStats()
+      assert.equal(typeof stats.loopLag.count, 'number')
+      assert.equal(stats.loopLag.histogram[stats.loopLag.histogram.length - 1].max, Infinity)
+      assert.equal(typeof stats.uvRun.totalTime, 'number')
+      assert.equal(typeof stats.handlers, 'object')
+    })
+
+    it('records the handlers of IPC messages', function () {
+      remote.process.getEventLoopStats()
+      const stats = remote.process.getEventLoopStats()
+      assert.ok(stats.handlers['ipc:ELECTRON_BROWSER_MEMBER_CALL'].count > 0)
+      assert.equal(stats.handlers['ipc-message-sync'], undefined)
+    })
+  })
+
   describe('process.version', function () {
     it('should not have -pre', function () {
       assert(!process.version.endsWith('-pre'))